@@ -0,0 +1,180 @@
+/*
+ * File: Agents.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: AgentModel class implementation
+ *              Receivers and satellites as coroutine agents on a Scheduler
+ * */
+
+#include<cmath>
+#include<cstdint>
+
+#include "Agents.hpp"
+
+AgentModel::AgentModel(std::vector<System>& systems_, double INR_max_, const AgentConfig& config_)
+    : systems(systems_), INR_max(INR_max_), config(config_), sched(config_.threads, config_.tick_s) {
+    INR_max_lin = LinkKernel::to_lin(INR_max);
+    std::size_t n_sats = 0, n_recs = 0;
+    for (const System& sys : systems) {
+        sat_base.push_back(n_sats);
+        rec_base.push_back(n_recs);
+        n_sats += sys.sats.size();
+        n_recs += sys.recs.size();
+        for (const Receiver& rec : sys.recs) {
+            links.emplace_back(rec);
+        }
+    }
+    sat_alive = std::make_unique<std::atomic<bool>[]>(n_sats);
+    rec_pair = std::make_unique<std::atomic<int>[]>(n_recs);
+    for (std::size_t i = 0; i < n_sats; ++i) {
+        sat_alive[i].store(true);
+    }
+    for (std::size_t j = 0; j < n_recs; ++j) {
+        rec_pair[j].store(-1);
+    }
+    sat_lost = std::make_unique<Event[]>(n_sats);
+    rec_interfered = std::make_unique<Event[]>(n_recs);
+}
+
+// exponential outage time, deterministic per satellite for a given seed
+double AgentModel::outageTime(std::size_t k, std::size_t i) const {
+    std::uint64_t x = (std::uint64_t(config.seed) << 40) ^ (std::uint64_t(k) << 32) ^ std::uint64_t(i);
+    // splitmix64
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    double u = (double(x >> 11) + 0.5) / double(1ULL << 53);
+    return -config.mean_lifetime_s * std::log(u);
+}
+
+// would sys k satellite i keep every primary receiver below INR_max
+bool AgentModel::protects(std::size_t k, std::size_t i) {
+    for (std::size_t v = 0; v < systems[0].recs.size(); ++v) {
+        int p = rec_pair[rec_base[0] + v].load();
+        if (p < 0) {
+            continue;
+        }
+        if (links[rec_base[0] + v].inr_lin(systems[0].sats[p], systems[k].sats[i]) >= INR_max_lin) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * best SNR live satellite for receiver j of system k, same criteria as SoS::satSelectBasic
+ * the receiver's ranked candidates are tried first, a constellation scan
+ * (which refills them) only happens once they are all lost or unusable
+ * */
+int AgentModel::select(std::size_t k, std::size_t j, bool protect) {
+    std::vector<Satellite>& sats = systems[k].sats;
+    Receiver& rec = systems[k].recs[j];
+    CandidateList& ranked = rec.getCandidates();
+    int current = rec_pair[rec_base[k] + j].load();
+
+    for (std::size_t c = 0; c < ranked.size(); ++c) {
+        int i = ranked[c].index;
+        if (i != current && sat_alive[sat_base[k] + i].load() && (!protect || protects(k, i))) {
+            return i;
+        }
+    }
+
+    full_scans++;
+    const LinkKernel& link = links[rec_base[k] + j];
+    ranked.reset(config.candidates);
+    for (int i = 0; i < int(sats.size()); ++i) {
+        if (!sat_alive[sat_base[k] + i].load()) {
+            continue;
+        }
+        double snr = link.snr_lin(sats[i]);
+        if (snr > g_min_select_lin && link.visible(sats[i]) && sats[i].getPt_dBm() >= rec.getPr_req_dBm()
+            && (!protect || protects(k, i))) {
+            ranked.offer(i, snr);
+        }
+    }
+    ranked.finalize(true);
+    return ranked.best();
+}
+
+AgentTask AgentModel::satelliteAgent(std::size_t k, std::size_t i) {
+    double t_fail = outageTime(k, i);
+    if (t_fail > config.t_end_s) {
+        co_return; // outlives the run, never needs to wake
+    }
+    co_await sched.sleepUntil(t_fail);
+    sat_alive[sat_base[k] + i].store(false);
+    outages++;
+    // latched: a receiver that picked this satellite in the same batch still hears of it
+    sat_lost[sat_base[k] + i].latch(sched);
+}
+
+AgentTask AgentModel::receiverAgent(std::size_t k, std::size_t j) {
+    std::atomic<int>& pair = rec_pair[rec_base[k] + j];
+    bool protect = k > 0;
+    bool interfered = false;
+
+    while (sched.now() <= config.t_end_s) {
+        int p = pair.load();
+        if (p < 0 || !sat_alive[sat_base[k] + p].load() || interfered) {
+            if (p >= 0) {
+                handovers++;
+            }
+            pair.store(select(k, j, protect));
+            p = pair.load();
+        }
+
+        // victims look for interference from every other system's active satellites
+        if (k == 0 && p >= 0) {
+            const LinkKernel& link = links[rec_base[0] + j];
+            for (std::size_t s = 1; s < systems.size(); ++s) {
+                for (std::size_t r = 0; r < systems[s].recs.size(); ++r) {
+                    int q = rec_pair[rec_base[s] + r].load();
+                    if (q >= 0 && link.inr_lin(systems[0].sats[p], systems[s].sats[q]) >= INR_max_lin) {
+                        interference_events++;
+                        rec_interfered[rec_base[s] + r].set(sched);
+                    }
+                }
+            }
+        }
+
+        std::vector<Event*> events{&rec_interfered[rec_base[k] + j]};
+        if (p >= 0) {
+            events.push_back(&sat_lost[sat_base[k] + p]);
+        }
+        bool woke_by_event = co_await sched.waitAny(events, config.recheck_s);
+        interfered = woke_by_event && p >= 0 && sat_alive[sat_base[k] + p].load();
+    }
+}
+
+AgentStats AgentModel::run() {
+    // phases within a batch: satellites (sat_alive), then primary receivers
+    // (read the other systems' pairings), then the others (read the primary pairings)
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        for (std::size_t i = 0; i < systems[k].sats.size(); ++i) {
+            sched.spawn(satelliteAgent(k, i), 0);
+        }
+        for (std::size_t j = 0; j < systems[k].recs.size(); ++j) {
+            sched.spawn(receiverAgent(k, j), k == 0 ? 1 : 2);
+        }
+    }
+    sched.run(config.t_end_s);
+
+    // write the final pairings back to the receivers
+    AgentStats stats;
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        for (std::size_t j = 0; j < systems[k].recs.size(); ++j) {
+            int p = rec_pair[rec_base[k] + j].load();
+            if (p >= 0) {
+                systems[k].recs[j].pairSat(systems[k].sats[p]);
+            } else {
+                stats.unserved++;
+            }
+        }
+    }
+    stats.resumes = sched.resumeCount();
+    stats.outages = outages.load();
+    stats.handovers = handovers.load();
+    stats.interference_events = interference_events.load();
+    stats.full_scans = full_scans.load();
+    return stats;
+}
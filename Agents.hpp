@@ -0,0 +1,82 @@
+/*
+ * File: Agents.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for AgentModel class
+ *              Receivers and satellites as coroutine agents on a Scheduler
+ * */
+
+#pragma once
+#include<atomic>
+#include<memory>
+#include<vector>
+
+#include "System.hpp"
+#include "Scheduler.hpp"
+#include "LinkKernel.hpp"
+
+struct AgentConfig
+{
+    double t_end_s = 3600;          // simulated time
+    double recheck_s = 60;          // receiver timer between interference checks
+    double mean_lifetime_s = 7200;  // mean time until a satellite drops out (exponential)
+    std::size_t candidates = 8;     // ranked fallbacks kept per receiver
+    unsigned seed = 1;
+    unsigned threads = 0;           // 0 -> hardware concurrency
+    double tick_s = 1.0;            // wake-ups rounded up to this grid and run as one batch, 0 -> exact times
+};
+
+struct AgentStats
+{
+    std::size_t resumes = 0;             // total agent wake-ups
+    std::size_t outages = 0;             // satellites lost
+    std::size_t handovers = 0;           // receiver re-selections, satellite lost or interfering
+    std::size_t full_scans = 0;          // re-selections that needed a constellation scan
+    std::size_t interference_events = 0; // threshold crossings reported by primary receivers
+    std::size_t unserved = 0;            // receivers left without a satellite at the end
+};
+
+/*
+ * satellite agent: sleeps until its outage time, then wakes the receivers using it
+ * receiver agent: sleeps until its satellite is lost, it is told it interferes,
+ *                 or its recheck timer expires
+ * primary receivers (systems[0]) check INR from every other system's active
+ * satellite on each wake-up and notify the offending receiver, which re-selects
+ * the best SNR satellite that keeps every primary receiver below INR_max
+ * agents woken at the same time run in three phases (satellites, primary
+ * receivers, other receivers), so every pairing a receiver reads was settled
+ * in an earlier phase and results do not depend on the thread count
+ * */
+class AgentModel {
+    public:
+    AgentModel(std::vector<System>&, double, const AgentConfig&);
+
+    AgentStats run();
+
+    private:
+    std::vector<System>& systems;
+    double INR_max;
+    double INR_max_lin;
+    AgentConfig config;
+    Scheduler sched;
+
+    // flattened per-object state, indexed through sat_base / rec_base per system
+    std::vector<std::size_t> sat_base;
+    std::vector<std::size_t> rec_base;
+    std::unique_ptr<std::atomic<bool>[]> sat_alive;
+    std::unique_ptr<std::atomic<int>[]> rec_pair; // index into the system's sats, -1 unpaired
+    std::unique_ptr<Event[]> sat_lost;
+    std::unique_ptr<Event[]> rec_interfered;
+    std::vector<LinkKernel> links; // per receiver, selection runs in linear units
+
+    std::atomic<std::size_t> outages{0};
+    std::atomic<std::size_t> handovers{0};
+    std::atomic<std::size_t> interference_events{0};
+    std::atomic<std::size_t> full_scans{0};
+
+    AgentTask satelliteAgent(std::size_t, std::size_t);
+    AgentTask receiverAgent(std::size_t, std::size_t);
+
+    double outageTime(std::size_t, std::size_t) const;
+    int select(std::size_t, std::size_t, bool);
+    bool protects(std::size_t, std::size_t);
+};
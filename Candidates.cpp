@@ -0,0 +1,57 @@
+/*
+ * File: Candidates.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: CandidateList class implementation
+ *              Ranked top-k satellite candidates kept from a selection pass
+ * */
+
+#include<algorithm>
+#include<cmath>
+
+#include "Candidates.hpp"
+
+void CandidateList::reset(std::size_t k_) {
+    k = std::max<std::size_t>(k_, 1);
+    heap.clear();
+    heap.reserve(k);
+    ranked.clear();
+    ranked_slots.clear();
+}
+
+bool CandidateList::offer(int index, double score) {
+    std::size_t slot;
+    return offer(index, score, slot);
+}
+
+bool CandidateList::offer(int index, double score, std::size_t& slot) {
+    Scored s{score, index, heap.size()};
+    if (heap.size() < k) {
+        heap.push_back(s);
+        std::push_heap(heap.begin(), heap.end(), better);
+        slot = s.slot;
+        return true;
+    }
+    if (better(s, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        s.slot = heap.back().slot;
+        heap.back() = s;
+        std::push_heap(heap.begin(), heap.end(), better);
+        slot = s.slot;
+        return true;
+    }
+    return false;
+}
+
+void CandidateList::finalize(bool linear) {
+    // ascending order under better() puts the best candidate first
+    std::sort_heap(heap.begin(), heap.end(), better);
+    ranked.resize(heap.size());
+    ranked_slots.resize(heap.size());
+    for (std::size_t i = 0; i < heap.size(); ++i) {
+        double score = linear ? 10.0 * std::log10(heap[i].score) : heap[i].score;
+        ranked[i] = Candidate{heap[i].index, float(score)};
+        ranked_slots[i] = heap[i].slot;
+    }
+    // the capacity is kept, k is fixed for a run and the next pass refills the heap
+    heap.clear();
+}
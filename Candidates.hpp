@@ -0,0 +1,64 @@
+/*
+ * File: Candidates.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for CandidateList class
+ *              Ranked top-k satellite candidates kept from a selection pass
+ * */
+
+#pragma once
+#include<algorithm>
+#include<cstddef>
+#include<vector>
+
+struct Candidate
+{
+    int index;   // index into the system's satellites
+    float score; // selection metric in dB (SNR or SINR)
+};
+
+/*
+ * bounded heap filled during a selection scan, finalize() turns it into a
+ * compact list ordered best first (ties go to the lower index, matching
+ * the strict > comparisons of the scalar selection loops)
+ * */
+class CandidateList {
+    public:
+    explicit CandidateList(std::size_t k_ = 8) : k(std::max<std::size_t>(k_, 1)) {}
+
+    // start a new pass keeping at most k_ candidates, at least 1 so the best is never lost
+    void reset(std::size_t);
+    // true if the candidate entered the list (it may still be pushed out later)
+    bool offer(int, double);
+    /*
+    * same, slot is set to the place in [0, k) the candidate took: the next free
+    * one while the list fills up, then the one of the candidate it pushed out,
+    * so callers can keep data per candidate in an array indexed by slot
+    * */
+    bool offer(int, double, std::size_t& slot);
+    // linear = true when offered scores are power ratios, stored scores are always dB
+    void finalize(bool linear = false);
+
+    bool empty() const { return ranked.empty(); }
+    std::size_t size() const { return ranked.size(); }
+    const Candidate& operator[](std::size_t i) const { return ranked[i]; }
+    // index of the best candidate, -1 if none passed
+    int best() const { return ranked.empty() ? -1 : ranked[0].index; }
+    // slot given by offer to the i-th ranked candidate
+    std::size_t slot(std::size_t i) const { return ranked_slots[i]; }
+
+    private:
+    struct Scored
+    {
+        double score;
+        int index;
+        std::size_t slot;
+    };
+    std::size_t k;
+    std::vector<Scored> heap; // only used during a pass, worst candidate on top
+    std::vector<Candidate> ranked;
+    std::vector<std::size_t> ranked_slots; // parallel to ranked
+
+    static bool better(const Scored& a, const Scored& b) {
+        return a.score > b.score || (a.score == b.score && a.index < b.index);
+    }
+};
@@ -0,0 +1,94 @@
+/*
+ * File: Channel.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: ChannelPlan class implementation
+ *              Set of channels a satellite or receiver operates on
+ * */
+
+#include<cmath>
+
+#include "Channel.hpp"
+
+ChannelPlan::ChannelPlan() {
+    channels = {{20e9, 400e6}};
+    f_ref = 20e9;
+    precompute();
+}
+
+ChannelPlan::ChannelPlan(const std::vector<Channel>& channels_, double f_ref_) {
+    channels = channels_;
+    f_ref = f_ref_;
+    precompute();
+}
+
+ChannelPlan ChannelPlan::uniform(double f_ref_, double B_total, int count) {
+    std::vector<Channel> ch;
+    double B_ch = B_total / count;
+    for (int k = 0; k < count; ++k) {
+        double fc = f_ref_ - B_total / 2.0 + (k + 0.5) * B_ch;
+        ch.push_back({fc, B_ch});
+    }
+    return ChannelPlan(ch, f_ref_);
+}
+
+// relative tolerance on frequencies, plans built from sums of doubles land within rounding
+static const double g_channel_tol = 1e-9;
+
+bool ChannelPlan::fitsBand(double fc, double B) const {
+    double tol = g_channel_tol * fc;
+    for (const Channel& ch : channels) {
+        if (!(ch.B > 0) || ch.fc - ch.B / 2.0 < fc - B / 2.0 - tol || ch.fc + ch.B / 2.0 > fc + B / 2.0 + tol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChannelPlan::sameChannels(const ChannelPlan& other) const {
+    if (other.size() != size()) {
+        return false;
+    }
+    for (std::size_t k = 0; k < size(); ++k) {
+        double tol = g_channel_tol * channels[k].fc;
+        if (std::abs(channels[k].fc - other[k].fc) > tol || std::abs(channels[k].B - other[k].B) > tol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChannelPlan::operator==(const ChannelPlan& other) const {
+    if (f_ref != other.f_ref || size() != other.size()) {
+        return false;
+    }
+    for (std::size_t k = 0; k < size(); ++k) {
+        if (channels[k].fc != other[k].fc || channels[k].B != other[k].B) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double ChannelPlan::refShift_dB(double fc) const {
+    return 20.0 * std::log10(f_ref / fc);
+}
+
+std::shared_ptr<const ChannelPlan> ChannelPlan::defaultPlan() {
+    static const std::shared_ptr<const ChannelPlan> plan = std::make_shared<const ChannelPlan>();
+    return plan;
+}
+
+void ChannelPlan::precompute() {
+    std::size_t n = channels.size();
+    fspl_const_dB.resize(n);
+    B_dB.resize(n);
+    gain_dB.resize(n);
+    psi_scale.resize(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        double lambda = g_C / channels[k].fc;
+        fspl_const_dB[k] = 20.0 * std::log10(4.0 * g_PI / lambda);
+        B_dB[k] = 10.0 * std::log10(channels[k].B);
+        psi_scale[k] = channels[k].fc / f_ref;
+        gain_dB[k] = 20.0 * std::log10(psi_scale[k]);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * File: Channel.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for ChannelPlan class
+ *              Set of channels a satellite or receiver operates on
+ * */
+
+#pragma once
+#include<memory>
+#include<vector>
+
+#include "MyUtil.hpp"
+
+struct Channel
+{
+    double fc; // center frequency Hz
+    double B;  // bandwidth Hz
+};
+
+/*
+ * per-channel constants are precomputed against the reference frequency f_ref
+ * an array half-wave spaced at carrier fc is (fc_k / fc) half-waves apart on
+ * channel k, so its aperture gain grows by 20 log10(fc_k / fc) and its array
+ * factor phase is scaled by fc_k / fc; the link budget rescales the f_ref
+ * constants to the carrier of each end (see refShift_dB)
+ * */
+class ChannelPlan {
+    public:
+    // single 20 GHz / 400 MHz channel, matches the scalar link budget
+    ChannelPlan();
+    ChannelPlan(const std::vector<Channel>&, double);
+
+    // count equal channels splitting [f_ref - B/2, f_ref + B/2]
+    static ChannelPlan uniform(double, double, int);
+    static std::shared_ptr<const ChannelPlan> defaultPlan();
+
+    std::size_t size() const { return channels.size(); }
+    const Channel& operator[](std::size_t k) const { return channels[k]; }
+    double getRefFc() const { return f_ref; }
+
+    // every channel inside [fc - B/2, fc + B/2] with positive bandwidth
+    bool fitsBand(double, double) const;
+    // same channel frequencies and bandwidths, in order
+    bool sameChannels(const ChannelPlan&) const;
+    // identical contents (channels and f_ref), used to share parameter records
+    bool operator==(const ChannelPlan&) const;
+    // 20 log10(f_ref / fc), moves apertureGain_dB to an array spaced for carrier fc
+    double refShift_dB(double fc) const;
+
+    // per-channel constants, precomputed so the link loops are adds only
+    const std::vector<double>& fsplConst_dB() const { return fspl_const_dB; }
+    const std::vector<double>& bandwidth_dB() const { return B_dB; }
+    const std::vector<double>& apertureGain_dB() const { return gain_dB; }
+    const std::vector<double>& phaseScale() const { return psi_scale; }
+
+    private:
+    std::vector<Channel> channels;
+    double f_ref; // frequency the arrays are half-wave spaced for, Hz
+
+    std::vector<double> fspl_const_dB; // 20 log10(4 pi fc / c), FSPL = this + 20 log10(range_m)
+    std::vector<double> B_dB;          // 10 log10(B)
+    std::vector<double> gain_dB;       // 20 log10(fc / f_ref)
+    std::vector<double> psi_scale;     // fc / f_ref
+
+    void precompute();
+};
@@ -0,0 +1,301 @@
+/*
+ * File: Chunked.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: ChunkedRunner class implementation
+ *              Satellite selection over constellations streamed from disk
+ * */
+
+#include<fstream>
+#include<iostream>
+#include<set>
+#include<sstream>
+#include<stdexcept>
+
+#include "Chunked.hpp"
+#include "Parallel.hpp"
+#include "LinkKernel.hpp"
+#include "ExclusionZone.hpp"
+
+ChunkedRunner::ChunkedRunner(std::vector<System>& systems_, double INR_max_, std::size_t top_k_,
+                             const ChunkConfig& config_)
+    : systems(systems_), INR_max(INR_max_), top_k(top_k_), config(config_) {
+    if (config.block == 0) {
+        config.block = 1;
+    }
+}
+
+std::size_t ChunkedRunner::slotOf(int sys_id) const {
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        if (systems[k].params.sys_id == sys_id) {
+            return k;
+        }
+    }
+    return systems.size();
+}
+
+std::size_t ChunkedRunner::held(const std::vector<Tracker>& trackers) const {
+    std::size_t n = 0;
+    for (const Tracker& t : trackers) {
+        n += t.held.size();
+    }
+    return n;
+}
+
+template<typename Body>
+bool ChunkedRunner::pass(const std::string& filename, const std::vector<bool>& keep, const Body& body) {
+    std::ifstream in(filename);
+    if (!in) {
+        std::cerr << "Error: could not open " << filename << "\n";
+        return false;
+    }
+    // the file is parsed once per pass, warnings only on the first
+    bool first = ++stats.passes == 1;
+    if (first) {
+        sat_count.assign(systems.size(), 0);
+    }
+    std::vector<int> next(systems.size(), 0);
+    std::set<int> unknown;
+    Block block;
+    block.sats.resize(systems.size());
+    block.idx.resize(systems.size());
+    std::size_t in_block = 0;
+
+    auto flush = [&]() {
+        if (in_block == 0) {
+            return;
+        }
+        std::size_t kept = 0;
+        for (const std::vector<Satellite>& sats : block.sats) {
+            kept += sats.size();
+        }
+        body(block);
+        ++stats.blocks;
+        stats.peak_resident = std::max(stats.peak_resident, kept + resident);
+        for (std::size_t k = 0; k < systems.size(); ++k) {
+            block.sats[k].clear();
+            block.idx[k].clear();
+        }
+        in_block = 0;
+    };
+
+    bool sats_section = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        int id, system;
+        double x_, y_;
+
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line == "Satellites:") {
+            sats_section = true;
+            continue;
+        } else if (line == "Systems:" || line == "Receivers:") {
+            sats_section = false;
+            continue;
+        }
+        if (!sats_section) {
+            continue;
+        }
+
+        std::istringstream iss(line);
+        if (!(iss >> system >> id >> x_ >> y_)) {
+            if (first) {
+                std::cerr << "Warning: bad input line (" << line << ")\n";
+            }
+            continue;
+        }
+        std::size_t k = slotOf(system);
+        if (k == systems.size()) {
+            if (first && unknown.insert(system).second) {
+                std::cerr << "Warning: satellites of system " << system << " have no receivers, skipped\n";
+            }
+            continue;
+        }
+        int index = next[k]++;
+        if (first) {
+            ++sat_count[k];
+            ++stats.satellites;
+        }
+        if (keep[k]) {
+            // aimed like SoS::aimSats
+            block.sats[k].emplace_back(system, id, Vec2(x_, y_), systems[k].sat_class);
+            block.sats[k].back().aimSat(systems[k].recs[0].getRecPos());
+            block.idx[k].push_back(index);
+        }
+        if (++in_block == config.block) {
+            flush();
+        }
+    }
+    flush();
+    return true;
+}
+
+template<typename Score>
+void ChunkedRunner::offerBlock(Tracker& t, const Block& block, const Score& score) {
+    const std::vector<Satellite>& sats = block.sats[t.slot];
+    const std::vector<int>& idx = block.idx[t.slot];
+    CandidateList& ranked = systems[t.slot].recs[0].getCandidates();
+
+    // scores in parallel, offers serial (ties go to the lower index either way)
+    std::vector<double> s(sats.size());
+    parallelFor(sats.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            s[i] = score(sats[i]);
+        }
+    }, config.threads);
+    std::size_t slot;
+    for (std::size_t i = 0; i < sats.size(); ++i) {
+        if (s[i] > 0 && ranked.offer(idx[i], s[i], slot)) {
+            // slots are handed out in order while the list fills up
+            if (slot == t.held.size()) {
+                t.held.push_back(sats[i]);
+            } else {
+                t.held[slot] = sats[i];
+            }
+        }
+    }
+}
+
+Satellite& ChunkedRunner::finish(Tracker& t) {
+    Receiver& rec = systems[t.slot].recs[0];
+    CandidateList& ranked = rec.getCandidates();
+    ranked.finalize(true);
+    int best_index = ranked.best();
+    if (best_index < 0) {
+        throw std::runtime_error{"ChunkedRunner: no valid satellite found"};
+    }
+    Satellite& sat = t.held[ranked.slot(0)];
+    rec.pairSat(sat);
+    return sat;
+}
+
+ChunkRunStats ChunkedRunner::run(const std::string& filename, int mode) {
+    stats = ChunkRunStats();
+    resident = 0;
+    if (mode < 1 || mode > 3) {
+        std::cerr << "Warning: unknown selection mode\n";
+        return stats;
+    }
+    if (systems.size() < 2) {
+        std::cout << "System empty" << std::endl;
+        return stats;
+    }
+    for (const System& sys : systems) {
+        if (sys.recs.empty()) {
+            std::cout << "System empty" << std::endl;
+            return stats;
+        }
+    }
+    const double min_select = g_min_select_lin;
+    const unsigned threads = config.threads;
+
+    // pass 1: every selection that only needs its own system
+    std::vector<Tracker> trackers;
+    std::vector<LinkKernel> links;
+    std::vector<bool> keep(systems.size(), false);
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        if (k == 1 && mode != 1) {
+            continue;
+        }
+        trackers.push_back({k, {}});
+        links.emplace_back(systems[k].recs[0]);
+        systems[k].recs[0].getCandidates().reset(top_k);
+        keep[k] = true;
+    }
+    bool ok = pass(filename, keep, [&](const Block& block) {
+        for (std::size_t j = 0; j < trackers.size(); ++j) {
+            const LinkKernel& link = links[j];
+            double Pr_req = systems[trackers[j].slot].recs[0].getPr_req_dBm();
+            offerBlock(trackers[j], block, [&](const Satellite& sat) {
+                double snr = link.snr_lin(sat);
+                return (snr > min_select && link.visible(sat) && sat.getPt_dBm() >= Pr_req) ? snr : 0.0;
+            });
+        }
+        resident = held(trackers);
+    });
+    if (!ok) {
+        return stats;
+    }
+    for (std::size_t n : sat_count) {
+        if (n == 0) {
+            std::cout << "System empty" << std::endl;
+            return stats;
+        }
+    }
+    for (Tracker& t : trackers) {
+        finish(t);
+    }
+    Receiver& U = systems[0].recs[0];
+    Receiver& V = systems[1].recs[0];
+    // satellite as selected, before pairSat activates it
+    Satellite sat1 = trackers[0].held[U.getCandidates().slot(0)];
+    trackers.clear();
+    resident = 0;
+
+    // pass 2: secondary selection knowing the primary pairing
+    V.setOutSysSat(U.getInSysSat());
+    if (mode != 1) {
+        Tracker t2{1, {}};
+        V.getCandidates().reset(top_k);
+        LinkKernel V_link(V);
+        double Pr_req = V.getPr_req_dBm();
+        ExclusionZone zone(U, U.getInSysSat(), INR_max);
+        std::vector<bool> keep2(systems.size(), false);
+        keep2[1] = true;
+        ok = pass(filename, keep2, [&](const Block& block) {
+            offerBlock(t2, block, [&](const Satellite& sat) {
+                if (!V_link.visible(sat) || sat.getPt_dBm() < Pr_req) {
+                    return 0.0;
+                }
+                double metric = mode == 2 ? V_link.snr_lin(sat) : V_link.sinr_lin(sat, sat1);
+                if (metric <= min_select || (mode == 2 && !zone.passes(sat))) {
+                    return 0.0;
+                }
+                return metric;
+            });
+            resident = t2.held.size();
+        });
+        if (!ok) {
+            return stats;
+        }
+        finish(t2);
+        resident = 0;
+    }
+    U.setOutSysSat(V.getInSysSat());
+
+    // pass 3: same quantities as SoS::summary
+    LinkKernel U_link(U);
+    LinkKernel V_link(V);
+    const Satellite& P_sat = U.getInSysSat();
+    const Satellite& S_sat = V.getInSysSat();
+    // one stream per system for the whole pass, the stream numbers satellites
+    // across read blocks, so nothing is held back between blocks
+    StatsStream stream1(2, threads);
+    StatsStream stream2(3, threads);
+    std::vector<bool> keep3(systems.size(), false);
+    keep3[0] = true;
+    keep3[1] = true;
+    ok = pass(filename, keep3, [&](Block& block) {
+        const std::vector<Satellite>& sats1 = block.sats[0];
+        const std::vector<Satellite>& sats2 = block.sats[1];
+        stream1.add(sats1.size(), [&](std::size_t i, StatsAccumulator& acc) {
+            acc.add(0, LinkKernel::to_dB(U_link.snr_lin(sats1[i])));
+            acc.add(1, LinkKernel::to_dB(V_link.sinr_lin(S_sat, sats1[i])));
+        });
+        stream2.add(sats2.size(), [&](std::size_t i, StatsAccumulator& acc) {
+            acc.add(0, LinkKernel::to_dB(V_link.snr_lin(sats2[i])));
+            acc.add(1, LinkKernel::to_dB(U_link.inr_lin(P_sat, sats2[i])));
+            acc.add(2, LinkKernel::to_dB(U_link.sinr_lin(P_sat, sats2[i])));
+        });
+    });
+    if (!ok) {
+        return stats;
+    }
+    std::vector<DistStats> sys1 = stream1.finish();
+    std::vector<DistStats> sys2 = stream2.finish();
+
+    stats.summary.names = {"SNR_sys1_dB", "SINR_sys2_dB", "SNR_sys2_dB", "INR_su_dB", "SINR_sys1_dB"};
+    stats.summary.metrics = {sys1[0], sys1[1], sys2[0], sys2[1], sys2[2]};
+    return stats;
+}
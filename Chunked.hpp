@@ -0,0 +1,86 @@
+/*
+ * File: Chunked.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for ChunkedRunner class
+ *              Satellite selection over constellations streamed from disk
+ * */
+
+#pragma once
+#include<string>
+#include<vector>
+
+#include "System.hpp"
+#include "Stats.hpp"
+
+struct ChunkConfig
+{
+    std::size_t block = 1 << 20; // satellites read per block, all systems together
+    unsigned threads = 0;        // 0 -> hardware concurrency
+};
+
+struct ChunkRunStats
+{
+    int passes = 0;               // reads of the satellite section
+    std::size_t blocks = 0;       // blocks read over all passes
+    std::size_t satellites = 0;   // satellites in the file, all systems
+    std::size_t peak_resident = 0; // most Satellite objects held at once
+    StatsSummary summary;         // same metrics as SoS::summary
+};
+
+/*
+ * systems and receivers must already be loaded (they are small), satellites
+ * are read from the file one block at a time and dropped after the block
+ *
+ * pass 1: best SNR for receiver 0 of every system that does not depend on
+ *         another system's choice (all of them in mode 1, all but the
+ *         secondary otherwise)
+ * pass 2: secondary selection against the primary pairing (modes 2 and 3),
+ *         protected mode screens with an ExclusionZone
+ * pass 3: SoS::summary statistics, streamed block after block (StatsStream)
+ * a pass that cannot open the file ends the run, the summary stays empty
+ *
+ * only the satellites behind the current top-k candidates are kept across
+ * blocks, candidate indices are positions within the system in file order,
+ * the same indices SoS::buildSystems would give, so the pairings, candidate
+ * lists and summary match the in-memory run on the same file
+ * */
+class ChunkedRunner {
+    public:
+    ChunkedRunner(std::vector<System>&, double, std::size_t, const ChunkConfig&);
+
+    ChunkRunStats run(const std::string&, int);
+
+    private:
+    std::vector<System>& systems;
+    double INR_max;
+    std::size_t top_k;
+    ChunkConfig config;
+    ChunkRunStats stats;
+    std::vector<std::size_t> sat_count; // per system slot, from the first pass
+    std::size_t resident = 0;           // satellites kept between blocks
+
+    // one pass over the satellite section, body(block) per block of satellites
+    // grouped by system slot, idx holds their per-system index in file order
+    struct Block
+    {
+        std::vector<std::vector<Satellite>> sats;
+        std::vector<std::vector<int>> idx;
+    };
+    template<typename Body>
+    bool pass(const std::string&, const std::vector<bool>&, const Body&);
+
+    // ranked selection of receiver 0 of a system, score(sat) <= 0 rejects
+    struct Tracker
+    {
+        std::size_t slot;
+        // satellites behind the current candidates, by CandidateList slot, a
+        // candidate pushed out of the list is overwritten in place
+        std::vector<Satellite> held;
+    };
+    template<typename Score>
+    void offerBlock(Tracker&, const Block&, const Score&);
+    Satellite& finish(Tracker&);
+
+    std::size_t slotOf(int) const;
+    std::size_t held(const std::vector<Tracker>&) const;
+};
@@ -0,0 +1,54 @@
+/*
+ * File: Constellation.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: parametric constellation and receiver layouts
+ *              used to populate SoS in memory without an input file
+ * */
+
+#include<fstream>
+#include<iostream>
+#include<limits>
+#include<map>
+
+#include "Constellation.hpp"
+
+Vec2 shellPosition(const ShellConfig& shell, std::size_t k) {
+    std::size_t plane = k / shell.sats_per_plane;
+    std::size_t slot = k % shell.sats_per_plane;
+    double offset = (double(slot) - 0.5 * (shell.sats_per_plane - 1)) * shell.spacing_km;
+    double phase = double(plane) * shell.phasing * shell.spacing_km / shell.planes;
+    return Vec2(shell.center_x_km + offset + phase, shell.altitude_km);
+}
+
+Vec2 recGridPosition(const RecGridConfig& grid, std::size_t k) {
+    double offset = (double(k) - 0.5 * (grid.count - 1)) * grid.spacing_km;
+    return Vec2(grid.center_x_km + offset, 0.0);
+}
+
+bool writeInputFile(const ConstellationConfig& config, const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return false;
+    }
+    // full precision so the file reproduces the in-memory layout exactly
+    out.precision(std::numeric_limits<double>::max_digits10);
+
+    std::map<int, int> next_id; // per system, IDs are 1-based and contiguous
+    out << "Receivers:\n";
+    for (const RecGridConfig& grid : config.rec_grids) {
+        for (int k = 0; k < grid.count; ++k) {
+            Vec2 pos = recGridPosition(grid, k);
+            out << grid.sys_id << ' ' << ++next_id[grid.sys_id] << ' ' << pos.x << ' ' << pos.y << ' ' << grid.dim << '\n';
+        }
+    }
+    next_id.clear();
+    out << "\nSatellites:\n";
+    for (const ShellConfig& shell : config.shells) {
+        for (std::size_t k = 0; k < shellSize(shell); ++k) {
+            Vec2 pos = shellPosition(shell, k);
+            out << shell.sys_id << ' ' << ++next_id[shell.sys_id] << ' ' << pos.x << ' ' << pos.y << '\n';
+        }
+    }
+    return bool(out);
+}
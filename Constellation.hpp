@@ -0,0 +1,69 @@
+/*
+ * File: Constellation.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: parametric constellation and receiver layouts
+ *              used to populate SoS in memory without an input file
+ * */
+
+#pragma once
+#include<cstddef>
+#include<string>
+#include<vector>
+
+#include "MyUtil.hpp"
+
+/*
+ * Walker-style shell projected onto the local 2-D slice
+ * each plane holds sats_per_plane satellites spaced spacing_km apart
+ * along track, plane p is shifted by p * phasing * spacing_km / planes
+ * (Walker phasing factor F) so the shell interleaves like T/P/F
+ * */
+struct ShellConfig
+{
+    int sys_id;
+    int planes;
+    int sats_per_plane;
+    double altitude_km;
+    double spacing_km;
+    int phasing = 0;
+    double center_x_km = 0; // shell is centered on this x coordinate
+};
+
+/*
+ * row of receivers on the surface (y = 0) centered on center_x_km
+ * */
+struct RecGridConfig
+{
+    int sys_id;
+    int count;
+    double spacing_km;
+    double dim; // NxN antenna array
+    double center_x_km = 0;
+};
+
+struct ConstellationConfig
+{
+    std::vector<ShellConfig> shells;
+    std::vector<RecGridConfig> rec_grids;
+};
+
+// total number of satellites in a shell
+inline std::size_t shellSize(const ShellConfig& shell) {
+    if (shell.planes <= 0 || shell.sats_per_plane <= 0) {
+        return 0;
+    }
+    return std::size_t(shell.planes) * std::size_t(shell.sats_per_plane);
+}
+
+// position of the k-th satellite of a shell, k in [0, shellSize)
+Vec2 shellPosition(const ShellConfig&, std::size_t);
+
+// position of the k-th receiver of a grid, k in [0, count)
+Vec2 recGridPosition(const RecGridConfig&, std::size_t);
+
+/*
+ * write the layout as an input file ("Receivers:" then "Satellites:"),
+ * satellites are streamed straight from shellPosition so files far larger
+ * than memory can be produced, IDs match generateSystems
+ * */
+bool writeInputFile(const ConstellationConfig&, const std::string&);
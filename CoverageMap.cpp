@@ -0,0 +1,117 @@
+/*
+ * File: CoverageMap.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: SNR / INR / SINR rasters over a grid of hypothetical receivers
+ * */
+
+#include<cmath>
+#include<cstdint>
+#include<fstream>
+#include<limits>
+
+#include "CoverageMap.hpp"
+#include "LinkKernel.hpp"
+#include "Parallel.hpp"
+
+CoverageMap computeCoverage(const std::vector<Satellite>& serving, const Satellite* interferer,
+                            const CoverageGrid& grid, unsigned threads) {
+    CoverageMap map;
+    map.grid = grid;
+    std::size_t n_points = std::size_t(std::max(grid.nx, 0)) * std::size_t(std::max(grid.ny, 0));
+    map.snr_dB.assign(n_points, 0);
+    map.inr_dB.assign(n_points, 0);
+    map.sinr_dB.assign(n_points, 0);
+
+    // constellation as flat arrays for the vectorized best-SNR search
+    std::size_t n = serving.size();
+    std::vector<double> sx(n), sy(n), eirp(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        sx[i] = serving[i].getSatPos().x;
+        sy[i] = serving[i].getSatPos().y;
+        eirp[i] = serving[i].getEIRP_mW();
+    }
+
+    double dx = (grid.x1 - grid.x0) / std::max(grid.nx, 1);
+    double dy = (grid.y1 - grid.y0) / std::max(grid.ny, 1);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    Receiver terminal(1, 0, Vec2(), grid.dim);
+
+    // running best SNR / index per point, carried across satellite blocks
+    std::vector<double> best_snr(n_points, 0);
+    std::vector<int> best_sat(n_points, -1);
+
+    // 32x32 points per tile and 1024 satellites (24 KB of x, y, EIRP) per block:
+    // a block stays in cache while every point of the thread's tiles is checked
+    // against it, so the constellation is streamed once per thread, not per point
+    const int tile = 32;
+    const std::size_t sat_block = 1024;
+    int tiles_x = (grid.nx + tile - 1) / tile;
+    int tiles_y = (grid.ny + tile - 1) / tile;
+    parallelFor(std::size_t(tiles_x) * std::size_t(tiles_y), [&](std::size_t begin, std::size_t end) {
+        LinkKernel link(terminal);
+        for (std::size_t s0 = 0; s0 < n; s0 += sat_block) {
+            std::size_t s_n = std::min(sat_block, n - s0);
+            for (std::size_t t = begin; t < end; ++t) {
+                int ix0 = int(t % tiles_x) * tile;
+                int iy0 = int(t / tiles_x) * tile;
+                int ix1 = std::min(grid.nx, ix0 + tile);
+                int iy1 = std::min(grid.ny, iy0 + tile);
+                for (int iy = iy0; iy < iy1; ++iy) {
+                    for (int ix = ix0; ix < ix1; ++ix) {
+                        std::size_t cell = std::size_t(iy) * grid.nx + ix;
+                        link.setPos(Vec2(grid.x0 + (ix + 0.5) * dx, grid.y0 + (iy + 0.5) * dy));
+                        int best;
+                        double snr = link.bestSNR_lin(sx.data() + s0, sy.data() + s0, eirp.data() + s0, s_n, best);
+                        // strictly better only, an earlier block keeps ties (first index overall)
+                        if (best >= 0 && snr > best_snr[cell]) {
+                            best_snr[cell] = snr;
+                            best_sat[cell] = int(s0) + best;
+                        }
+                    }
+                }
+            }
+        }
+        for (std::size_t t = begin; t < end; ++t) {
+            int ix0 = int(t % tiles_x) * tile;
+            int iy0 = int(t / tiles_x) * tile;
+            int ix1 = std::min(grid.nx, ix0 + tile);
+            int iy1 = std::min(grid.ny, iy0 + tile);
+            for (int iy = iy0; iy < iy1; ++iy) {
+                for (int ix = ix0; ix < ix1; ++ix) {
+                    std::size_t cell = std::size_t(iy) * grid.nx + ix;
+                    int best = best_sat[cell];
+                    if (best < 0) {
+                        map.snr_dB[cell] = map.inr_dB[cell] = map.sinr_dB[cell] = nan;
+                        continue;
+                    }
+                    link.setPos(Vec2(grid.x0 + (ix + 0.5) * dx, grid.y0 + (iy + 0.5) * dy));
+                    double snr = best_snr[cell];
+                    double inr = interferer ? link.inr_lin(serving[best], *interferer) : 0.0;
+                    // dB only at the output
+                    map.snr_dB[cell] = float(LinkKernel::to_dB(snr));
+                    map.inr_dB[cell] = interferer ? float(LinkKernel::to_dB(inr)) : -std::numeric_limits<float>::infinity();
+                    map.sinr_dB[cell] = float(LinkKernel::to_dB(snr / (1.0 + inr)));
+                }
+            }
+        }
+    }, threads);
+    return map;
+}
+
+bool CoverageMap::write(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return false;
+    }
+    std::int32_t nx = grid.nx, ny = grid.ny;
+    double bounds[4] = {grid.x0, grid.x1, grid.y0, grid.y1};
+    out.write("COV1", 4);
+    out.write(reinterpret_cast<const char*>(&nx), sizeof(nx));
+    out.write(reinterpret_cast<const char*>(&ny), sizeof(ny));
+    out.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+    for (const std::vector<float>* layer : {&snr_dB, &inr_dB, &sinr_dB}) {
+        out.write(reinterpret_cast<const char*>(layer->data()), layer->size() * sizeof(float));
+    }
+    return bool(out);
+}
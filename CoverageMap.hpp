@@ -0,0 +1,51 @@
+/*
+ * File: CoverageMap.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: SNR / INR / SINR rasters over a grid of hypothetical receivers
+ * */
+
+#pragma once
+#include<string>
+#include<vector>
+
+#include "Receiver.hpp"
+
+/*
+ * grid of receiver positions in the local frame
+ * x: km along the surface, y: km above the surface (0 for ground terminals)
+ * points are cell centers, nx * ny points in total
+ * */
+struct CoverageGrid
+{
+    double x0, x1;
+    int nx;
+    double y0, y1;
+    int ny;
+    double dim = 8; // NxN antenna array of the hypothetical terminal
+};
+
+/*
+ * one float per grid point and layer, row major (row = y index)
+ * points with no visible satellite hold NaN
+ * */
+struct CoverageMap
+{
+    CoverageGrid grid;
+    std::vector<float> snr_dB;
+    std::vector<float> inr_dB;
+    std::vector<float> sinr_dB;
+
+    /*
+    * binary raster: "COV1", int32 nx, int32 ny, double x0 x1 y0 y1,
+    * then the SNR, INR and SINR layers as float32
+    * */
+    bool write(const std::string&) const;
+};
+
+/*
+ * each point pairs with its best SNR satellite of the serving constellation and
+ * is interfered by one active satellite of another system (nullptr: no interferer)
+ * the grid is split into cache-sized tiles spread across threads, each thread
+ * checks its tiles against one cache-sized block of satellites at a time
+ * */
+CoverageMap computeCoverage(const std::vector<Satellite>&, const Satellite*, const CoverageGrid&, unsigned threads = 0);
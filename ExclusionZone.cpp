@@ -0,0 +1,83 @@
+/*
+ * File: ExclusionZone.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: ExclusionZone class implementation
+ *              Geometric INR screening around one primary link
+ * */
+
+#include<algorithm>
+#include<cmath>
+
+#include "ExclusionZone.hpp"
+
+// bracket widening so rounding in the exact path can never flip a screened decision
+static const double g_zone_margin = 1.01;
+
+ExclusionZone::ExclusionZone(const Receiver& U_rec, const Satellite& P, double INR_th_dB)
+    : link(U_rec), P_sat(P) {
+    to_P = P.recToSat(U_rec.getRecPos());
+    N = U_rec.getArrayDim();
+    M = U_rec.getSatArrayDim();
+    N2 = N * N;
+    M2 = M * M;
+    thr_lin = LinkKernel::to_lin(INR_th_dB);
+    double ratio = g_PI / 3.141592653589793;
+    env_c = ratio * ratio;
+    core_r = g_PI * g_PI / 24.0;
+}
+
+ExclusionZone::Class ExclusionZone::bracket(const Satellite& S, Terms& t) const {
+    Vec2 to_S = S.recToSat(link.getPos());
+    t.r2 = to_S.dot(to_S);
+    double K = S.getEIRP_mW() * link.linkGain() / (t.r2 * 1e6); // INR with both AF = 1
+
+    // far enough that even boresight on both arrays is below threshold
+    if (K * g_zone_margin < thr_lin) {
+        return Safe;
+    }
+
+    t.sin2_r = LinkKernel::sin2Between(to_P, to_S);
+    t.sin2_t = LinkKernel::sin2Between(S.getSatDir(), S.satToRec(link.getPos()));
+
+    // AF >= 1 - x^2 / 6 with x^2 = dim^2 g_PI^2 sin^2 / 4
+    double lo_r = std::max(0.0, 1.0 - core_r * N2 * t.sin2_r);
+    double lo_t = std::max(0.0, 1.0 - core_r * M2 * t.sin2_t);
+    if (K * lo_r * lo_r * lo_t * lo_t > thr_lin * g_zone_margin) {
+        return Violating;
+    }
+
+    double up_r = std::min(1.0, 1.0 / (N2 * env_c * t.sin2_r));
+    double up_t = std::min(1.0, 1.0 / (M2 * env_c * t.sin2_t));
+    if (K * up_r * up_t * g_zone_margin < thr_lin) {
+        return Safe;
+    }
+    return Boundary;
+}
+
+// same operand order as LinkKernel::inr_lin so the decision is bit-identical
+bool ExclusionZone::exact(const Satellite& S, const Terms& t) const {
+    double AF_t = LinkKernel::arrayFactor2(t.sin2_t, M);
+    double AF_r = LinkKernel::arrayFactor2(t.sin2_r, N);
+    return S.getEIRP_mW() * AF_t * AF_r * link.linkGain() / (t.r2 * 1e6) < thr_lin;
+}
+
+ExclusionZone::Class ExclusionZone::classify(const Satellite& S) const {
+    Terms t;
+    return bracket(S, t);
+}
+
+bool ExclusionZone::passesExact(const Satellite& S) const {
+    return link.inr_lin(P_sat, S) < thr_lin;
+}
+
+bool ExclusionZone::passes(const Satellite& S) const {
+    Terms t;
+    switch (bracket(S, t)) {
+        case Safe:
+            return true;
+        case Violating:
+            return false;
+        default:
+            return exact(S, t);
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * File: ExclusionZone.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for ExclusionZone class
+ *              Geometric INR screening around one primary link
+ * */
+
+#pragma once
+
+#include "LinkKernel.hpp"
+
+/*
+ * region of interfering satellite positions that push INR on a primary
+ * receiver U (paired with P) past a threshold
+ *
+ * both array factors are bounded from cross products alone:
+ *   sidelobe envelope  AF^2 <= min(1, 1 / (dim^2 c sin^2))   c = (g_PI / pi)^2
+ *   main lobe core     AF   >= 1 - x^2 / 6                   x = dim g_PI sin / 2
+ * so INR is bracketed without any trig; only candidates whose bracket
+ * straddles the threshold need the exact array factors
+ * */
+class ExclusionZone {
+    public:
+    enum Class { Safe, Violating, Boundary };
+
+    // U must already be paired with P, threshold in dB
+    ExclusionZone(const Receiver&, const Satellite&, double);
+
+    Class classify(const Satellite&) const;
+    // exact test, same decision as calc_INR(P, sat) < threshold
+    bool passesExact(const Satellite&) const;
+    // classify() and fall back to the exact test near the boundary
+    bool passes(const Satellite&) const;
+
+    private:
+    // per-candidate geometry shared by the bounds and the exact test
+    struct Terms {
+        double r2;      // |U -> S|^2, km^2
+        double sin2_r;  // off boresight at U, toward P
+        double sin2_t;  // off boresight at S, toward its own receiver
+    };
+    Class bracket(const Satellite&, Terms&) const;
+    bool exact(const Satellite&, const Terms&) const;
+
+    LinkKernel link;
+    Satellite P_sat;
+    Vec2 to_P;        // U -> P, km
+    double N, M;      // array dimensions of U and the interferers
+    double N2, M2;    // squared
+    double thr_lin;   // INR threshold, linear
+    double env_c;     // (g_PI / pi)^2
+    double core_r;    // g_PI^2 / 24, main lobe core coefficient
+};
@@ -0,0 +1,135 @@
+/*
+ * File: Geometry.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: Earth-centred geometry
+ *              ECEF / ENU / geodetic transforms, SoA position storage and
+ *              batched range / elevation for constellations on the globe
+ * */
+
+#include<algorithm>
+#include<stdexcept>
+#include<string>
+
+#include "Geometry.hpp"
+#include "Parallel.hpp"
+
+Vec3 geodeticToECEF(const Geodetic& g) {
+    double s = std::sin(g.lat);
+    double c = std::cos(g.lat);
+    double N = g_earth_a_km / std::sqrt(1.0 - g_earth_e2 * s * s); // prime vertical radius
+    return Vec3((N + g.h_km) * c * std::cos(g.lon),
+                (N + g.h_km) * c * std::sin(g.lon),
+                (N * (1.0 - g_earth_e2) + g.h_km) * s);
+}
+
+Geodetic ecefToGeodetic(Vec3 p) {
+    double lon = std::atan2(p.y, p.x);
+    double r = std::hypot(p.x, p.y);
+    double b = g_earth_a_km * (1.0 - g_earth_f);
+    double ep2 = g_earth_e2 / (1.0 - g_earth_e2);
+
+    // reduced latitude start point, then Bowring updates
+    double beta = std::atan2(p.z * g_earth_a_km, r * b);
+    double lat = 0;
+    for (int k = 0; k < 3; ++k) {
+        double sb = std::sin(beta);
+        double cb = std::cos(beta);
+        lat = std::atan2(p.z + ep2 * b * sb * sb * sb, r - g_earth_e2 * g_earth_a_km * cb * cb * cb);
+        beta = std::atan2((1.0 - g_earth_f) * std::sin(lat), std::cos(lat));
+    }
+    double s = std::sin(lat);
+    double N = g_earth_a_km / std::sqrt(1.0 - g_earth_e2 * s * s);
+    double h;
+    if (std::abs(std::cos(lat)) > 1e-9) {
+        h = r / std::cos(lat) - N;
+    } else {
+        h = std::abs(p.z) - b; // at the poles
+    }
+    return {lat, lon, h};
+}
+
+ENUFrame::ENUFrame(const Geodetic& g) {
+    o = geodeticToECEF(g);
+    double sl = std::sin(g.lat), cl = std::cos(g.lat);
+    double so = std::sin(g.lon), co = std::cos(g.lon);
+    e = Vec3(-so, co, 0);
+    n = Vec3(-sl * co, -sl * so, cl);
+    u = Vec3(cl * co, cl * so, sl);
+}
+
+Vec3 ENUFrame::toENU(Vec3 ecef) const {
+    Vec3 d = ecef - o;
+    return Vec3(d.dot(e), d.dot(n), d.dot(u));
+}
+
+Vec3 ENUFrame::toECEF(Vec3 enu) const {
+    return o + e * enu.x + n * enu.y + u * enu.z;
+}
+
+void rangeElevation(const ENUFrame& f, const PositionsSoA& p, std::size_t begin, std::size_t end,
+                    double* range2, double* sin_el) {
+    const double* px = p.x.data();
+    const double* py = p.y.data();
+    const double* pz = p.z.data();
+    Vec3 o = f.origin();
+    Vec3 u = f.up();
+    // elevation is the angle above the local horizon: sin(el) = (d . up) / |d|
+    for (std::size_t i = begin; i < end; ++i) {
+        double dx = px[i] - o.x;
+        double dy = py[i] - o.y;
+        double dz = pz[i] - o.z;
+        double r2 = dx*dx + dy*dy + dz*dz;
+        range2[i - begin] = r2;
+        // a position at the origin is straight overhead, as in Receiver::getElevationAngle
+        sin_el[i - begin] = r2 > 0 ? (dx*u.x + dy*u.y + dz*u.z) / std::sqrt(r2) : 1.0;
+    }
+}
+
+void toENU(const ENUFrame& f, const PositionsSoA& in, PositionsSoA& out, unsigned threads) {
+    out.resize(in.size());
+    Vec3 o = f.origin(), e = f.east(), n = f.north(), u = f.up();
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            double dx = in.x[i] - o.x;
+            double dy = in.y[i] - o.y;
+            double dz = in.z[i] - o.z;
+            out.x[i] = dx*e.x + dy*e.y + dz*e.z;
+            out.y[i] = dx*n.x + dy*n.y + dz*n.z;
+            out.z[i] = dx*u.x + dy*u.y + dz*u.z;
+        }
+    }, threads);
+}
+
+void walkerECEF(const WalkerConfig& w, double t_s, PositionsSoA& out, unsigned threads) {
+    std::size_t total = std::max(w.total, 0);
+    out.resize(total);
+    if (total == 0 || w.planes <= 0) {
+        return;
+    }
+    if (w.total % w.planes != 0) {
+        throw std::runtime_error{"walkerECEF: " + std::to_string(w.total) + " satellites do not split evenly into "
+                                 + std::to_string(w.planes) + " planes"};
+    }
+    int per_plane = w.total / w.planes;
+    double r = g_earth_a_km + w.altitude_km;
+    double inc = w.inclination_deg * g_geo_pi / 180.0;
+    double ci = std::cos(inc), si = std::sin(inc);
+    double mean_motion = std::sqrt(g_earth_mu / (r * r * r));
+    double earth_turn = g_earth_omega * t_s; // ECI -> ECEF
+
+    parallelFor(total, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            int plane = int(k) / per_plane;
+            int slot = int(k) % per_plane;
+            double raan = w.raan0_deg * g_geo_pi / 180.0 + 2.0 * g_geo_pi * plane / w.planes - earth_turn;
+            double arg = 2.0 * g_geo_pi * slot / per_plane
+                       + 2.0 * g_geo_pi * w.phasing * plane / w.total
+                       + mean_motion * t_s;
+            double cr = std::cos(raan), sr = std::sin(raan);
+            double ca = std::cos(arg), sa = std::sin(arg);
+            out.x[k] = r * (cr * ca - sr * sa * ci);
+            out.y[k] = r * (sr * ca + cr * sa * ci);
+            out.z[k] = r * sa * si;
+        }
+    }, threads);
+}
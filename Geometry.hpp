@@ -0,0 +1,119 @@
+/*
+ * File: Geometry.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Earth-centred geometry
+ *              ECEF / ENU / geodetic transforms, SoA position storage and
+ *              batched range / elevation for constellations on the globe
+ * */
+
+#pragma once
+#include<cmath>
+#include<cstddef>
+#include<vector>
+
+// the link budget keeps g_PI, coordinates need the full value
+const double g_geo_pi = 3.141592653589793;
+
+// WGS84 ellipsoid, km
+const double g_earth_a_km = 6378.137;
+const double g_earth_f = 1.0 / 298.257223563;
+const double g_earth_e2 = g_earth_f * (2.0 - g_earth_f);
+const double g_earth_omega = 7.2921150e-5;  // rotation rate, rad/s
+const double g_earth_mu = 398600.4418;      // km^3/s^2
+
+struct Vec3
+{
+    double x, y, z;
+
+    // Constructors
+    Vec3() : x(0), y(0), z(0) {}
+    Vec3(double x_, double y_, double z_) : x(x_), y(y_), z(z_) {}
+
+    // Operations
+    Vec3 operator+(Vec3 o) const { return {x+o.x, y+o.y, z+o.z}; }
+    Vec3 operator-(Vec3 o) const { return {x-o.x, y-o.y, z-o.z}; }
+    Vec3 operator*(double s) const { return {x*s, y*s, z*s}; }
+
+    inline double dot(Vec3 o) const noexcept { return x*o.x + y*o.y + z*o.z; }
+    inline Vec3 cross(Vec3 o) const noexcept { return {y*o.z - z*o.y, z*o.x - x*o.z, x*o.y - y*o.x}; }
+    inline double magnitude_km() const noexcept { return std::sqrt(dot(*this)); }
+    inline Vec3 unitVec() const noexcept {
+        double mag = magnitude_km();
+        return mag>0 ? Vec3{x/mag, y/mag, z/mag} : Vec3{0,0,0};
+    }
+};
+
+// latitude / longitude in radians, height above the ellipsoid in km
+struct Geodetic
+{
+    double lat, lon, h_km;
+};
+
+Vec3 geodeticToECEF(const Geodetic&);
+// Bowring's iteration, converged to well below a millimetre after 3 steps
+Geodetic ecefToGeodetic(Vec3);
+
+/*
+ * local east / north / up frame at a point on the ellipsoid
+ * the 2-D local frame of Vec2 is the east-up slice of this frame
+ * */
+class ENUFrame {
+    public:
+    explicit ENUFrame(const Geodetic&);
+
+    Vec3 origin() const { return o; }
+    Vec3 east() const { return e; }
+    Vec3 north() const { return n; }
+    Vec3 up() const { return u; }
+
+    Vec3 toENU(Vec3 ecef) const;
+    Vec3 toECEF(Vec3 enu) const;
+
+    private:
+    Vec3 o;       // ECEF origin, km
+    Vec3 e, n, u; // ECEF unit axes
+};
+
+/*
+ * structure-of-arrays positions, km
+ * batched loops walk x, y, z as separate contiguous arrays so they vectorize
+ * */
+struct PositionsSoA
+{
+    std::vector<double> x, y, z;
+
+    std::size_t size() const { return x.size(); }
+    void resize(std::size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+    void set(std::size_t i, Vec3 p) { x[i] = p.x; y[i] = p.y; z[i] = p.z; }
+    Vec3 get(std::size_t i) const { return {x[i], y[i], z[i]}; }
+};
+
+/*
+ * squared range (km^2) and sine of elevation of positions [begin, end) seen
+ * from the frame origin, written to range2[i - begin] and sin_el[i - begin]
+ * */
+void rangeElevation(const ENUFrame&, const PositionsSoA&, std::size_t begin, std::size_t end,
+                    double* range2, double* sin_el);
+
+// every position of in expressed in the frame, spread across threads
+void toENU(const ENUFrame&, const PositionsSoA& in, PositionsSoA& out, unsigned threads = 0);
+
+/*
+ * Walker delta constellation T/P/F on circular orbits
+ * satellite k sits in plane k / (T / P), slot k % (T / P)
+ * T must be a multiple of P
+ * */
+struct WalkerConfig
+{
+    int sys_id;
+    int total;             // T
+    int planes;            // P
+    int phasing;           // F
+    double altitude_km;
+    double inclination_deg;
+    double raan0_deg = 0;  // right ascension of the first plane
+};
+
+// ECEF positions at t seconds after epoch (ECI = ECEF at t = 0), filled in parallel
+// throws std::runtime_error when T is not a multiple of P
+void walkerECEF(const WalkerConfig&, double t_s, PositionsSoA&, unsigned threads = 0);
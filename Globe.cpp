@@ -0,0 +1,92 @@
+/*
+ * File: Globe.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: protected selection for terminal pairs spread over the globe
+ * */
+
+#include<fstream>
+#include<iostream>
+
+#include "Globe.hpp"
+#include "Parallel.hpp"
+
+std::vector<GlobePairing> globeProtectedSelection(const GlobeSystem& sys1, const GlobeSystem& sys2,
+                                                  const std::vector<GlobeSite>& sites,
+                                                  const Receiver& U_rec, const Receiver& V_rec,
+                                                  unsigned threads) {
+    std::vector<GlobePairing> out(sites.size());
+    const std::size_t n2 = sys2.sats.size();
+    const double sin_min_el = std::sin(g_min_el_angle);
+
+    parallelFor(sites.size(), [&](std::size_t begin, std::size_t end) {
+        // scratch per thread, reused across sites
+        std::vector<double> inr(n2), range2(n2), sin_el(n2);
+        for (std::size_t k = begin; k < end; ++k) {
+            GlobePairing& p = out[k];
+            p.where = sites[k].where;
+
+            LinkKernel3D U(U_rec, sites[k].where);
+            Geodetic v_where = ecefToGeodetic(U.frame().toECEF(Vec3(sites[k].v_offset_km, 0, 0)));
+            v_where.h_km = sites[k].where.h_km;
+            LinkKernel3D V(V_rec, v_where);
+
+            // same -1 dB selection floor as the 2-D selection
+            double snr1 = U.bestSNR_lin(sys1.sats, sys1.eirp_mW, p.sat1);
+            if (p.sat1 < 0 || snr1 <= g_min_select_lin) {
+                p.sat1 = -1;
+                continue;
+            }
+            Vec3 P = sys1.sats.get(p.sat1);
+
+            // protection test on U, then best SNR at V among the survivors
+            U.inr_lin(P, sys2.sats, V.getPos(), sys2.eirp_mW, inr.data());
+            rangeElevation(V.frame(), sys2.sats, 0, n2, range2.data(), sin_el.data());
+            double min_r2 = INF;
+            for (std::size_t i = 0; i < n2; ++i) {
+                if (sin_el[i] >= sin_min_el && inr[i] < U.inrMax_lin() && range2[i] < min_r2) {
+                    min_r2 = range2[i];
+                    p.sat2 = int(i);
+                }
+            }
+
+            p.SNR1_dB = LinkKernel::to_dB(snr1);
+            if (p.sat2 < 0) {
+                continue;
+            }
+            double snr2 = V.snr_lin(sys2.sats.get(p.sat2), sys2.eirp_mW);
+            if (snr2 <= g_min_select_lin) {
+                p.sat2 = -1;
+                continue;
+            }
+            double inr_su = inr[p.sat2];
+            p.SNR2_dB = LinkKernel::to_dB(snr2);
+            p.INR_su_dB = LinkKernel::to_dB(inr_su);
+            p.SINR1_dB = LinkKernel::to_dB(snr1 / (1.0 + inr_su));
+        }
+    }, threads);
+    return out;
+}
+
+bool globe_out(const std::string& filename, const std::vector<GlobePairing>& pairs) {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return false;
+    }
+    for (const GlobePairing& p : pairs) {
+        out << p.where.lat * 180.0 / g_geo_pi << ',' << p.where.lon * 180.0 / g_geo_pi << ','
+            << p.sat1 << ',' << p.sat2 << ',';
+        // unserved links stay empty, same as the short rows of calc_data.txt
+        if (p.sat1 >= 0) {
+            out << p.SNR1_dB;
+        }
+        out << ',';
+        if (p.sat2 >= 0) {
+            out << p.SNR2_dB << ',' << p.INR_su_dB << ',' << p.SINR1_dB;
+        } else {
+            out << ",,";
+        }
+        out << '\n';
+    }
+    return bool(out);
+}
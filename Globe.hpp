@@ -0,0 +1,55 @@
+/*
+ * File: Globe.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: protected selection for terminal pairs spread over the globe
+ * */
+
+#pragma once
+#include<string>
+#include<vector>
+
+#include "LinkKernel3D.hpp"
+
+// one primary / secondary constellation on the globe, one EIRP per system
+struct GlobeSystem
+{
+    int sys_id;
+    PositionsSoA sats; // ECEF, km
+    double eirp_mW;
+};
+
+/*
+ * terminal pair at one site: primary terminal U at the site, secondary
+ * terminal V offset east along the surface (km), same as the 2-D scenario
+ * */
+struct GlobeSite
+{
+    Geodetic where;
+    double v_offset_km = -1.0;
+};
+
+struct GlobePairing
+{
+    Geodetic where;
+    int sat1 = -1;      // index into the primary constellation, -1 if unserved
+    int sat2 = -1;      // index into the secondary constellation
+    double SNR1_dB = NAN;
+    double SNR2_dB = NAN;
+    double INR_su_dB = NAN; // secondary satellite on U
+    double SINR1_dB = NAN;
+};
+
+/*
+ * per site: U takes its best SNR primary satellite, V its best SNR secondary
+ * satellite whose INR on U stays below U's INR_max (secondary satellites
+ * aimed at V), range / elevation and INR are evaluated in batches over the
+ * whole constellation, sites are spread across threads
+ * U_rec / V_rec only provide the terminal class (array, noise, thresholds)
+ * */
+std::vector<GlobePairing> globeProtectedSelection(const GlobeSystem&, const GlobeSystem&,
+                                                  const std::vector<GlobeSite>&,
+                                                  const Receiver& U_rec, const Receiver& V_rec,
+                                                  unsigned threads = 0);
+
+// #lat_deg, lon_deg, sat1, sat2, SNR_sys1_dB, SNR_sys2_dB, INR_su_dB, SINR_sys1_dB
+bool globe_out(const std::string&, const std::vector<GlobePairing>&);
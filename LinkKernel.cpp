@@ -0,0 +1,106 @@
+/*
+ * File: LinkKernel.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: LinkKernel class implementation
+ *              Link budget of one receiver in linear power units
+ * */
+
+#include<algorithm>
+#include<cmath>
+
+#include "LinkKernel.hpp"
+
+LinkKernel::LinkKernel(const Receiver& rec) {
+    rec_pos = rec.getRecPos();
+    N = rec.getArrayDim();
+    M = rec.getSatArrayDim();
+    double path = rec.getLambda() / (4.0 * g_PI);
+    link_gain = to_lin(rec.getGr_dBi()) * path * path / to_lin(rec.getPn_dBm());
+    SNR_min_lin = to_lin(rec.getSNR_min());
+    INR_max_lin = to_lin(rec.getINR_max());
+    tan_min_el = std::tan(g_min_el_angle);
+}
+
+double LinkKernel::sin2Between(Vec2 a, Vec2 b) {
+    double aa = a.dot(a);
+    double bb = b.dot(b);
+    if (aa == 0 || bb == 0) {
+        return 1.0;
+    }
+    double cross = a.x * b.y - a.y * b.x;
+    return std::min(1.0, cross * cross / (aa * bb));
+}
+
+double LinkKernel::arrayFactor2(double sin2, double dim) {
+    double psi = g_PI * std::sqrt(sin2);
+    double den = std::sin(psi / 2.0);
+    if (std::abs(den) < 1e-8) {
+        return 1.0;
+    }
+    double AF = std::sin(dim * psi / 2.0) / (dim * den);
+    return AF * AF;
+}
+
+double LinkKernel::snr_lin(const Satellite& sat) const {
+    Vec2 v = sat.recToSat(rec_pos);
+    double r2 = v.dot(v) * 1e6; // km^2 -> m^2
+    return sat.getEIRP_mW() * link_gain / r2;
+}
+
+double LinkKernel::inr_lin(const Satellite& in_sat, const Satellite& out_sat) const {
+    Vec2 to_out = out_sat.recToSat(rec_pos);
+    double r2 = to_out.dot(to_out) * 1e6;
+    double AF_t = arrayFactor2(sin2Between(out_sat.getSatDir(), out_sat.satToRec(rec_pos)), M);
+    double AF_r = arrayFactor2(sin2Between(in_sat.recToSat(rec_pos), to_out), N);
+    return out_sat.getEIRP_mW() * AF_t * AF_r * link_gain / r2;
+}
+
+double LinkKernel::sinr_lin(const Satellite& in_sat, const Satellite& out_sat) const {
+    return snr_lin(in_sat) / (1.0 + inr_lin(in_sat, out_sat));
+}
+
+double LinkKernel::bestSNR_lin(const double* x, const double* y, const double* eirp_mW,
+                               std::size_t n, int& best) const {
+    // per-lane running max with the index that set it, branch-free so the
+    // loop vectorizes, lanes are merged at the end (ties go to the lower index)
+    double rx = rec_pos.x;
+    double ry = rec_pos.y;
+    double t = tan_min_el;
+    double lane_snr[g_kernel_lanes] = {};
+    std::size_t lane_idx[g_kernel_lanes] = {};
+    auto step = [&](std::size_t i, std::size_t l) {
+        double dx = x[i] - rx;
+        double dy = y[i] - ry;
+        bool vis = dx == 0 || std::abs(dy) >= t * std::abs(dx);
+        double snr = vis ? eirp_mW[i] / ((dx*dx + dy*dy) * 1e6) : 0.0;
+        bool better = snr > lane_snr[l];
+        lane_snr[l] = better ? snr : lane_snr[l];
+        lane_idx[l] = better ? i : lane_idx[l];
+    };
+    std::size_t blocked = n - n % g_kernel_lanes;
+    for (std::size_t i = 0; i < blocked; i += g_kernel_lanes) {
+        for (std::size_t l = 0; l < g_kernel_lanes; ++l) {
+            step(i + l, l);
+        }
+    }
+    for (std::size_t i = blocked; i < n; ++i) {
+        step(i, i - blocked);
+    }
+    best = -1;
+    double max_snr = 0;
+    for (std::size_t l = 0; l < g_kernel_lanes; ++l) {
+        if (lane_snr[l] > max_snr || (best >= 0 && lane_snr[l] == max_snr && int(lane_idx[l]) < best)) {
+            max_snr = lane_snr[l];
+            best = int(lane_idx[l]);
+        }
+    }
+    return max_snr * link_gain;
+}
+
+bool LinkKernel::visible(const Satellite& sat) const {
+    Vec2 v = sat.recToSat(rec_pos);
+    if (v.x == 0) {
+        return true; // straight overhead, pi/2
+    }
+    return std::abs(v.y) >= tan_min_el * std::abs(v.x);
+}
@@ -0,0 +1,70 @@
+/*
+ * File: LinkKernel.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for LinkKernel class
+ *              Link budget of one receiver in linear power units
+ * */
+
+#pragma once
+#include<cmath>
+#include<cstddef>
+
+#include "Receiver.hpp"
+
+// selection floor, candidates need SNR / SINR above -1 dB (linear)
+const double g_min_select_lin = 0.7943282347242815;
+
+// batched best-SNR loops keep this many running maxima, one per SIMD lane
+const std::size_t g_kernel_lanes = 4;
+
+/*
+ * same link chain as Receiver::calc_SNR / calc_INR / calc_SINR but kept in
+ * linear power ratios on squared distances:
+ *   SNR = Pt Gt Gr (lambda / 4 pi)^2 / (r^2 Pn)
+ *   INR = Pt Gt AF_t^2 Gr AF_r^2 (lambda / 4 pi)^2 / (r^2 Pn)
+ * sin(theta) comes from cross products instead of acos, thresholds are
+ * converted to linear once, dB values only appear through to_dB()
+ * */
+class LinkKernel {
+    public:
+    explicit LinkKernel(const Receiver&);
+
+    // evaluate the same terminal at another position (coverage grids)
+    void setPos(Vec2 pos) { rec_pos = pos; }
+    Vec2 getPos() const { return rec_pos; }
+    double linkGain() const { return link_gain; }
+    double tanMinEl() const { return tan_min_el; }
+
+    /*
+    * best SNR over a constellation stored as arrays (x, y in km, EIRP in mW)
+    * returns the linear SNR and sets best to the first index reaching it,
+    * -1 if nothing is above the elevation mask
+    * */
+    double bestSNR_lin(const double*, const double*, const double*, std::size_t, int&) const;
+
+    double snr_lin(const Satellite&) const;
+    double inr_lin(const Satellite&, const Satellite&) const;
+    double sinr_lin(const Satellite&, const Satellite&) const;
+    // elevation mask, same test as |getElevationAngle| >= g_min_el_angle without atan
+    bool visible(const Satellite&) const;
+
+    double snrMin_lin() const { return SNR_min_lin; }
+    double inrMax_lin() const { return INR_max_lin; }
+
+    static double to_lin(double dB) { return std::pow(10.0, dB / 10.0); }
+    static double to_dB(double lin) { return 10.0 * std::log10(lin); }
+
+    // squared array factor for half-wave spacing, sin2 = sin^2 of the off-boresight angle
+    static double arrayFactor2(double sin2, double dim);
+    // sin^2 of the angle between a and b, 1 if either is zero (acos(0) in the reference)
+    static double sin2Between(Vec2 a, Vec2 b);
+
+    private:
+    Vec2 rec_pos;     // km
+    double N;         // receiver array dimension
+    double M;         // satellite array dimension
+    double link_gain; // Gr (lambda / 4 pi)^2 / Pn, per mW of Pt Gt and per m^2
+    double SNR_min_lin;
+    double INR_max_lin;
+    double tan_min_el;
+};
@@ -0,0 +1,133 @@
+/*
+ * File: LinkKernel3D.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: LinkKernel3D class implementation
+ *              Link budget of one terminal on the globe in linear power units
+ * */
+
+#include<algorithm>
+
+#include "LinkKernel3D.hpp"
+
+LinkKernel3D::LinkKernel3D(const Receiver& rec, const Geodetic& where) : enu(where) {
+    LinkKernel flat(rec);
+    N = rec.getArrayDim();
+    M = rec.getSatArrayDim();
+    link_gain = flat.linkGain();
+    SNR_min_lin = flat.snrMin_lin();
+    INR_max_lin = flat.inrMax_lin();
+    double s = std::sin(g_min_el_angle);
+    sin2_min_el = s * s;
+}
+
+double LinkKernel3D::sin2Between(Vec3 a, Vec3 b) {
+    double aa = a.dot(a);
+    double bb = b.dot(b);
+    if (aa == 0 || bb == 0) {
+        return 1.0;
+    }
+    Vec3 c = a.cross(b);
+    return std::min(1.0, c.dot(c) / (aa * bb));
+}
+
+// up component >= sin(min el) * range, squared to skip the sqrt
+bool LinkKernel3D::visible(Vec3 sat) const {
+    Vec3 d = sat - enu.origin();
+    double up = d.dot(enu.up());
+    return up > 0 && up * up >= sin2_min_el * d.dot(d);
+}
+
+double LinkKernel3D::snr_lin(Vec3 sat, double eirp_mW) const {
+    Vec3 d = sat - enu.origin();
+    return eirp_mW * link_gain / (d.dot(d) * 1e6);
+}
+
+double LinkKernel3D::inr_lin(Vec3 in, Vec3 out, Vec3 out_target, double eirp_mW) const {
+    Vec3 pos = enu.origin();
+    Vec3 to_out = out - pos;
+    double AF_t = LinkKernel::arrayFactor2(sin2Between(out_target - out, pos - out), M);
+    double AF_r = LinkKernel::arrayFactor2(sin2Between(in - pos, to_out), N);
+    return eirp_mW * AF_t * AF_r * link_gain / (to_out.dot(to_out) * 1e6);
+}
+
+double LinkKernel3D::sinr_lin(Vec3 in, double in_eirp_mW, Vec3 out, Vec3 out_target, double out_eirp_mW) const {
+    return snr_lin(in, in_eirp_mW) / (1.0 + inr_lin(in, out, out_target, out_eirp_mW));
+}
+
+double LinkKernel3D::bestSNR_lin(const PositionsSoA& sats, double eirp_mW, int& best) const {
+    // SNR only falls with range for one EIRP: per-lane running min over visible
+    // ranges with the index that set it, merged at the end (ties go to the lower index)
+    const double* px = sats.x.data();
+    const double* py = sats.y.data();
+    const double* pz = sats.z.data();
+    Vec3 o = enu.origin();
+    Vec3 u = enu.up();
+    double s2 = sin2_min_el;
+    std::size_t n = sats.size();
+    double lane_r2[g_kernel_lanes];
+    std::size_t lane_idx[g_kernel_lanes] = {};
+    std::fill(lane_r2, lane_r2 + g_kernel_lanes, INF);
+    auto step = [&](std::size_t i, std::size_t l) {
+        double dx = px[i] - o.x;
+        double dy = py[i] - o.y;
+        double dz = pz[i] - o.z;
+        double r2 = dx*dx + dy*dy + dz*dz;
+        double up = dx*u.x + dy*u.y + dz*u.z;
+        bool vis = up > 0 && up * up >= s2 * r2;
+        bool better = vis && r2 < lane_r2[l];
+        lane_r2[l] = better ? r2 : lane_r2[l];
+        lane_idx[l] = better ? i : lane_idx[l];
+    };
+    std::size_t blocked = n - n % g_kernel_lanes;
+    for (std::size_t i = 0; i < blocked; i += g_kernel_lanes) {
+        for (std::size_t l = 0; l < g_kernel_lanes; ++l) {
+            step(i + l, l);
+        }
+    }
+    for (std::size_t i = blocked; i < n; ++i) {
+        step(i, i - blocked);
+    }
+    best = -1;
+    double min_r2 = INF;
+    for (std::size_t l = 0; l < g_kernel_lanes; ++l) {
+        if (lane_r2[l] < min_r2 || (best >= 0 && lane_r2[l] == min_r2 && int(lane_idx[l]) < best)) {
+            min_r2 = lane_r2[l];
+            best = int(lane_idx[l]);
+        }
+    }
+    if (best < 0) {
+        return 0;
+    }
+    return eirp_mW * link_gain / (min_r2 * 1e6);
+}
+
+void LinkKernel3D::inr_lin(Vec3 in, const PositionsSoA& out, Vec3 out_target, double eirp_mW, double* inr) const {
+    const double* px = out.x.data();
+    const double* py = out.y.data();
+    const double* pz = out.z.data();
+    Vec3 o = enu.origin();
+    Vec3 a = in - o; // receive boresight
+    double aa = a.dot(a);
+    std::size_t n = out.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        // terminal -> interferer
+        double dx = px[i] - o.x;
+        double dy = py[i] - o.y;
+        double dz = pz[i] - o.z;
+        double r2 = dx*dx + dy*dy + dz*dz;
+        // interferer -> its own target, transmit boresight
+        double tx = out_target.x - px[i];
+        double ty = out_target.y - py[i];
+        double tz = out_target.z - pz[i];
+        double tt = tx*tx + ty*ty + tz*tz;
+
+        // |a x d|^2 and |t x (-d)|^2
+        double cx = a.y*dz - a.z*dy, cy = a.z*dx - a.x*dz, cz = a.x*dy - a.y*dx;
+        double sin2_r = (aa == 0 || r2 == 0) ? 1.0 : std::min(1.0, (cx*cx + cy*cy + cz*cz) / (aa * r2));
+        double ex = ty*dz - tz*dy, ey = tz*dx - tx*dz, ez = tx*dy - ty*dx;
+        double sin2_t = (tt == 0 || r2 == 0) ? 1.0 : std::min(1.0, (ex*ex + ey*ey + ez*ez) / (tt * r2));
+
+        inr[i] = eirp_mW * LinkKernel::arrayFactor2(sin2_t, M) * LinkKernel::arrayFactor2(sin2_r, N)
+               * link_gain / (r2 * 1e6);
+    }
+}
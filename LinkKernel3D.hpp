@@ -0,0 +1,56 @@
+/*
+ * File: LinkKernel3D.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for LinkKernel3D class
+ *              Link budget of one terminal on the globe in linear power units
+ * */
+
+#pragma once
+
+#include "LinkKernel.hpp"
+#include "Geometry.hpp"
+
+/*
+ * LinkKernel on ECEF positions (km)
+ * same link chain and array model as LinkKernel, sin^2 of the off-boresight
+ * angles comes from |a x b|^2 / (|a|^2 |b|^2) and the elevation mask is taken
+ * against the local up vector instead of the flat-earth atan(v / h)
+ *
+ * satellites are not objects here: positions come from PositionsSoA and each
+ * interferer is aimed at a target position (its own terminal)
+ * */
+class LinkKernel3D {
+    public:
+    // terminal class (array, noise, thresholds) from the receiver, position on the globe
+    LinkKernel3D(const Receiver&, const Geodetic&);
+
+    const ENUFrame& frame() const { return enu; }
+    Vec3 getPos() const { return enu.origin(); }
+    double snrMin_lin() const { return SNR_min_lin; }
+    double inrMax_lin() const { return INR_max_lin; }
+
+    bool visible(Vec3) const;
+    double snr_lin(Vec3, double eirp_mW) const;
+    // interferer at out aimed at out_target, this terminal pointed at in
+    double inr_lin(Vec3 in, Vec3 out, Vec3 out_target, double eirp_mW) const;
+    double sinr_lin(Vec3 in, double in_eirp_mW, Vec3 out, Vec3 out_target, double out_eirp_mW) const;
+
+    /*
+    * batched forms over a whole constellation with one EIRP
+    * bestSNR_lin: best visible satellite, index in best (-1 if none)
+    * inr_lin: INR of every satellite of out (each aimed at out_target) into inr[]
+    * */
+    double bestSNR_lin(const PositionsSoA&, double eirp_mW, int& best) const;
+    void inr_lin(Vec3 in, const PositionsSoA& out, Vec3 out_target, double eirp_mW, double* inr) const;
+
+    static double sin2Between(Vec3, Vec3);
+
+    private:
+    ENUFrame enu;
+    double N;         // receiver array dimension
+    double M;         // satellite array dimension
+    double link_gain; // Gr (lambda / 4 pi)^2 / Pn, per mW of Pt Gt and per m^2
+    double SNR_min_lin;
+    double INR_max_lin;
+    double sin2_min_el;
+};
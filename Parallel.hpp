@@ -0,0 +1,51 @@
+/*
+ * File: Parallel.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: parallel loop helper built on std::thread
+ * */
+
+#pragma once
+#include<algorithm>
+#include<cstddef>
+#include<thread>
+#include<vector>
+
+// number of worker threads to use, 0 -> hardware concurrency
+inline unsigned workerCount(unsigned requested = 0) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+/*
+ * split [0, n) into contiguous chunks and run body(begin, end) on each chunk
+ * chunks are handed out in order, one per thread, so each thread touches a
+ * contiguous block of memory
+ * */
+template<typename Body>
+void parallelFor(std::size_t n, const Body& body, unsigned threads = 0) {
+    if (n == 0) {
+        return;
+    }
+    std::size_t t = std::min<std::size_t>(workerCount(threads), n);
+    if (t == 1) {
+        body(std::size_t(0), n);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(t);
+    std::size_t chunk = (n + t - 1) / t;
+    for (std::size_t k = 0; k < t; ++k) {
+        std::size_t begin = k * chunk;
+        std::size_t end = std::min(n, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        pool.emplace_back([&body, begin, end]() { body(begin, end); });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+}
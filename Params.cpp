@@ -0,0 +1,112 @@
+/*
+ * File: Params.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: Shared parameter records for satellites and receivers
+ *              Objects share one record from ParamTable instead of
+ *              their own copy of values identical across a system
+ * */
+
+#include<cmath>
+
+#include "Params.hpp"
+
+void SatParams::calcSignalStuff() {
+    lambda = g_C / fc; // wavelength
+    double dx = 0.5 * lambda; // half-wave spacing
+    double dy = dx;
+    A = (M*dx)*(N*dy); // aperature area
+    Gt_lin = eta * (4.0 * g_PI * A) / (lambda*lambda); // linear transmit gain
+    Gt_dBi = 10.0 * std::log10(Gt_lin); // transmit gain dBi ~38.8 ish
+
+    Pt_dBW = Sp + 10.0 * std::log10(bandwidth);
+    EIRP_dBm = Pt_dBW + 30 + Gt_dBi;
+    EIRP_mW = std::pow(10.0, (Pt_dBW + 30) / 10.0) * Gt_lin;
+}
+
+bool SatParams::sameInputs(const SatParams& o) const {
+    return sys_id == o.sys_id && Sp == o.Sp && fc == o.fc && bandwidth == o.bandwidth
+        && eta == o.eta && M == o.M && N == o.N && samePlan(channels, o.channels);
+}
+
+void RecParams::calcSignalStuff() {
+    lambda = g_C/fc;
+
+    double dx = 0.5 * lambda;
+    Aeff = (N*dx)*(N*dx);
+
+    Gr_lin = eta * 4.0 * g_PI * Aeff / (lambda*lambda);
+    Gr_dBi = 10.0 * std::log10(Gr_lin);
+
+    Pn_dBm = 10.0 * std::log10(g_K * T0 * B) + 30; // dBm -> -174 dBm/Hz + 10 log_10(B)
+    Pn_dBm += nf;
+    Pr_req_dBm = Pn_dBm + SNR_min;
+}
+
+bool RecParams::sameInputs(const RecParams& o) const {
+    return N == o.N && fc == o.fc && B == o.B && M == o.M && eta == o.eta && T0 == o.T0
+        && nf == o.nf && SNR_min == o.SNR_min && INR_max == o.INR_max && samePlan(channels, o.channels);
+}
+
+template<typename P>
+std::shared_ptr<const P> ParamTable::intern(Table<P>& t, const P& params) {
+    std::lock_guard<std::mutex> lock(t.m);
+    // records nobody holds any more are dropped on the way
+    std::erase_if(t.records, [](const std::weak_ptr<const P>& w) { return w.expired(); });
+    for (const std::weak_ptr<const P>& w : t.records) {
+        std::shared_ptr<const P> record = w.lock();
+        if (record && record->sameInputs(params)) {
+            return record;
+        }
+    }
+    P derived = params;
+    derived.calcSignalStuff();
+    std::shared_ptr<const P> record = std::make_shared<const P>(derived);
+    t.records.push_back(record);
+    return record;
+}
+
+template<typename P>
+std::size_t ParamTable::live(Table<P>& t) {
+    std::lock_guard<std::mutex> lock(t.m);
+    std::size_t count = 0;
+    for (const std::weak_ptr<const P>& w : t.records) {
+        count += !w.expired();
+    }
+    return count;
+}
+
+ParamTable::Table<SatParams>& ParamTable::sats() {
+    static Table<SatParams> table;
+    return table;
+}
+
+ParamTable::Table<RecParams>& ParamTable::recs() {
+    static Table<RecParams> table;
+    return table;
+}
+
+SatParamsPtr ParamTable::sat(const SatParams& params) {
+    return intern(sats(), params);
+}
+
+RecParamsPtr ParamTable::rec(const RecParams& params) {
+    return intern(recs(), params);
+}
+
+const SatParamsPtr& ParamTable::defaultSat() {
+    static const SatParamsPtr record = sat(SatParams());
+    return record;
+}
+
+const RecParamsPtr& ParamTable::defaultRec() {
+    static const RecParamsPtr record = rec(RecParams());
+    return record;
+}
+
+std::size_t ParamTable::satCount() {
+    return live(sats());
+}
+
+std::size_t ParamTable::recCount() {
+    return live(recs());
+}
@@ -0,0 +1,109 @@
+/*
+ * File: Params.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Shared parameter records for satellites and receivers
+ *              Objects share one record from ParamTable instead of
+ *              their own copy of values identical across a system
+ * */
+
+#pragma once
+#include<memory>
+#include<mutex>
+#include<vector>
+
+#include "Channel.hpp"
+
+// one record per system (and channel plan)
+struct SatParams
+{
+    int sys_id = 0;
+    double Sp = -54.3;        // transmit power spectral density dBW/Hz
+    double fc = 20e9;         // Hz
+    double bandwidth = 400e6; // Hz
+    double eta = 0.6;         // aperture efficiency
+    int M = 64, N = 64;       // 64x64 antenna array
+    std::shared_ptr<const ChannelPlan> channels = ChannelPlan::defaultPlan();
+
+    // derived by calcSignalStuff
+    double lambda;
+    double A;
+    double Gt_lin; // boresight transmit gain linear
+    double Gt_dBi; // boresight transmit gain dBi
+    double Pt_dBW;
+    double EIRP_dBm;
+    double EIRP_mW; // linear Pt * Gt for the linear link kernel
+
+    void calcSignalStuff();
+    bool sameInputs(const SatParams&) const;
+};
+
+// one record per terminal class (array size and channel plan)
+struct RecParams
+{
+    double N = 1;           // NxN antenna array
+    double fc = 20e9;       // Hz
+    double B = 400e6;       // Hz
+    double M = 64;          // satellite array dimension
+    double eta = 0.6;
+    double T0 = 290;        // noise temperature K
+    double nf = 1.2;        // noise figure dB
+    double SNR_min = 25;    // minimum threshold for signal to noise ratio dB
+    double INR_max = -12.2; // threshold for prohibitive interference
+    std::shared_ptr<const ChannelPlan> channels = ChannelPlan::defaultPlan();
+
+    // derived by calcSignalStuff
+    double lambda;
+    double Gr_dBi;     // boresight receive gain in dBi
+    double Gr_lin;     // boresight receive gain linear
+    double Aeff;       // effective area of receiver
+    double Pn_dBm;     // noise power in dBm
+    double Pr_req_dBm; // minimum required receive power
+
+    void calcSignalStuff();
+    bool sameInputs(const RecParams&) const;
+};
+
+using SatParamsPtr = std::shared_ptr<const SatParams>;
+using RecParamsPtr = std::shared_ptr<const RecParams>;
+
+// same channel plan contents, shared pointers to equal plans compare equal
+inline bool samePlan(const std::shared_ptr<const ChannelPlan>& a, const std::shared_ptr<const ChannelPlan>& b) {
+    return a == b || (a && b && *a == *b);
+}
+
+/*
+ * process-wide intern table, records are never modified once derived
+ * every object holds a shared pointer to its record, so a record lives
+ * exactly as long as some satellite, receiver or system uses it; the table
+ * keeps weak references only, to hand out one record per distinct input
+ * */
+class ParamTable {
+    public:
+    // record with identical inputs, created (with derived values) if none is alive
+    static SatParamsPtr sat(const SatParams&);
+    static RecParamsPtr rec(const RecParams&);
+
+    // records of default constructed objects
+    static const SatParamsPtr& defaultSat();
+    static const RecParamsPtr& defaultRec();
+
+    // live records, for diagnostics
+    static std::size_t satCount();
+    static std::size_t recCount();
+
+    private:
+    template<typename P>
+    struct Table
+    {
+        std::mutex m;
+        std::vector<std::weak_ptr<const P>> records;
+    };
+
+    static Table<SatParams>& sats();
+    static Table<RecParams>& recs();
+
+    template<typename P>
+    static std::shared_ptr<const P> intern(Table<P>&, const P&);
+    template<typename P>
+    static std::size_t live(Table<P>&);
+};
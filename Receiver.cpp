@@ -8,6 +8,7 @@
 #include<cmath>
 #include<algorithm>
 #include<limits>
+#include<stdexcept>
 
 #include "Receiver.hpp"
 
@@ -16,10 +17,11 @@ Receiver::Receiver(int sys_id_, int rec_id_, Vec2 pos_, double dim_) {
     rec_id = rec_id_;
     rec_pos = pos_;
     //rec_type = type_;
-    N = dim_;
+    RecParams terminal;
+    terminal.N = dim_;
+    param = ParamTable::rec(terminal);
     in_sys_sat_def = false;
     out_sys_sat_def = false;
-    calcSignalStuff();
 }
 
 Receiver::Receiver() {
@@ -27,10 +29,9 @@ Receiver::Receiver() {
     rec_id = 0;
     rec_pos = Vec2();
     //rec_type = 1;
-    N = 1;
+    param = ParamTable::defaultRec(); // default terminal, 1x1 array
     in_sys_sat_def = false;
     out_sys_sat_def = false;
-    calcSignalStuff();
 }
 
 Receiver::~Receiver() {
@@ -43,14 +44,36 @@ int Receiver::getRecID() const { return rec_id; }
 
 Vec2 Receiver::getRecPos() const { return rec_pos; }
 
-double Receiver::getPr_req_dBm() const { return Pr_req_dBm; }
+double Receiver::getPr_req_dBm() const { return params().Pr_req_dBm; }
 
-double Receiver::getGr_dBi() const { return Gr_dBi; };
+double Receiver::getGr_dBi() const { return params().Gr_dBi; };
+
+bool Receiver::isPaired() const { return in_sys_sat_def; }
+
+double Receiver::getLambda() const { return params().lambda; }
+
+double Receiver::getArrayDim() const { return params().N; }
+
+double Receiver::getSatArrayDim() const { return params().M; }
+
+double Receiver::getPn_dBm() const { return params().Pn_dBm; }
+
+double Receiver::getSNR_min() const { return params().SNR_min; }
+
+double Receiver::getINR_max() const { return params().INR_max; }
+
+CandidateList& Receiver::getCandidates() { return candidates; }
+
+const CandidateList& Receiver::getCandidates() const { return candidates; }
 
 Satellite& Receiver::getInSysSat() {
     return in_sys_sat;
 }
 
+const Satellite& Receiver::getInSysSat() const {
+    return in_sys_sat;
+}
+
 Satellite& Receiver::getOutSysSat() {
     return out_sys_sat;
 }
@@ -71,6 +94,21 @@ void Receiver::setRecPos(double x_, double y_) {
     rec_pos = Vec2(x_, y_);
 }
 
+void Receiver::setChannelPlan(std::shared_ptr<const ChannelPlan> plan) {
+    if (!plan->fitsBand(params().fc, params().B)) {
+        throw std::runtime_error{"channel plan outside the receiver band"};
+    }
+    RecParams terminal = params();
+    terminal.channels = plan;
+    param = ParamTable::rec(terminal);
+}
+
+const ChannelPlan& Receiver::getChannelPlan() const { return *params().channels; }
+
+void Receiver::setParams(RecParamsPtr param_) {
+    param = std::move(param_);
+}
+
 void Receiver::pairSat(Satellite& sat) {
     in_sys_sat = sat;
     in_sys_sat.activate();
@@ -100,26 +138,12 @@ double Receiver::getElevationAngle(Vec2 sat_pos) {
     return theta;
 }
 
-void Receiver::calcSignalStuff() {
-    lambda = g_C/fc;
-
-    double dx = 0.5 * lambda;
-    Aeff = (N*dx)*(N*dx);
-
-    Gr_lin = eta * 4.0 * g_PI * Aeff / (lambda*lambda);
-    Gr_dBi = 10.0 * std::log10(Gr_lin);
-
-    Pn_dBm = 10.0 * std::log10(g_K * T0 * B) + 30; // dBm -> -174 dBm/Hz + 10 log_10(B)
-    Pn_dBm += nf;
-    Pr_req_dBm = Pn_dBm + SNR_min;
-}
-
 // FSPL(this, sat) in dB
 double Receiver::calc_FSPL_dB(const Satellite& sat) {
     double temp;
     Vec2 vec = sat.recToSat(rec_pos);
     double range = vec.magnitude_m();
-    temp = 4.0 * g_PI * range / lambda; // squared in return
+    temp = 4.0 * g_PI * range / params().lambda; // squared in return
     return 20.0 * std::log10(temp);
 }
 
@@ -128,9 +152,10 @@ double Receiver::calc_SNR(const Satellite& sat) {
     double Pt_dBm = sat.getPt_dBm();
     double Gt_dBi = sat.getGt_dBi();
     double fspl = calc_FSPL_dB(sat);
+    const RecParams& p = params();
 
     // Ptx(sat) + Gtx(this, sat) + Grx(this, sat) - L(this, sat) - Pn(this)
-    return Pt_dBm + Gt_dBi + Gr_dBi - fspl - Pn_dBm;
+    return Pt_dBm + Gt_dBi + p.Gr_dBi - fspl - p.Pn_dBm;
 }
 
 // angle between aim of sat and direction to rec
@@ -144,6 +169,7 @@ double Receiver::calc_sat_int_angle(const Satellite& sat) {
 // transmit gain of interference in dBi
 double Receiver::calc_Gt_int(const Satellite& sat) {
     double theta = calc_sat_int_angle(sat);
+    double M = params().M;
     double psi = g_PI * std::sin(theta); // for half wave spacing
     double num = std::sin(M * psi / 2.0);
     double den = std::sin(psi / 2.0);
@@ -168,6 +194,7 @@ double Receiver::calc_rec_int_angle(const Satellite& in_sat, const Satellite& ou
 // receive gain of interference in dBi
 double Receiver::calc_Gr_int(const Satellite& in_sat, const Satellite& out_sat) {
     double theta = calc_rec_int_angle(in_sat, out_sat);
+    double N = params().N;
     double psi = g_PI * std::sin(theta); // for half wave spacing
     double num = std::sin(N * psi / 2.0);
     double den = std::sin(psi / 2.0);
@@ -178,7 +205,7 @@ double Receiver::calc_Gr_int(const Satellite& in_sat, const Satellite& out_sat)
         AF_norm = (1 / N) * num / den;
     }
     double AF_dB = 20.0 * std::log10(std::abs(AF_norm));
-    return Gr_dBi + AF_dB;
+    return params().Gr_dBi + AF_dB;
 }
 
 // INR(this, in_sys_sat; sat) in dB
@@ -189,7 +216,7 @@ double Receiver::calc_INR(const Satellite& in_sat, const Satellite& out_sat) {
     double FSPL = calc_FSPL_dB(out_sat);
 
     // Ptx(s) + Gtx(u, s;v) + Grx(u, s;p) - L(u, s) - Pn(u)
-    return Pt_dBm + Gt_int_dBi + Gr_int_dBi - FSPL - Pn_dBm;
+    return Pt_dBm + Gt_int_dBi + Gr_int_dBi - FSPL - params().Pn_dBm;
 }
 
 double Receiver::calc_SINR(const Satellite& in_sat, const Satellite& out_sat) {
@@ -201,4 +228,99 @@ double Receiver::calc_SINR(const Satellite& in_sat, const Satellite& out_sat) {
     // -> snr_dB - 10*log10(1 + inr_lin)
     sinr = snr_dB - 10.0 * std::log10(1.0 + std::pow(10.0, inr_dB/10.0));
     return sinr;
+}
+
+// channel k of the satellite transmits into channel k of the receiver
+void Receiver::checkChannelPlan(const Satellite& sat) const {
+    if (!sat.getChannelPlan().sameChannels(getChannelPlan())) {
+        throw std::runtime_error{"channel plan of satellite does not match receiver"};
+    }
+}
+
+// array factor in dB at angle theta off boresight, psi scaled for the channel
+static double channelAF_dB(double sin_theta, double scale, double dim) {
+    double psi = g_PI * scale * sin_theta;
+    double den = std::sin(psi / 2.0);
+    if (std::abs(den) < 1e-8) {
+        return 0.0;
+    }
+    double AF_norm = (1 / dim) * std::sin(dim * psi / 2.0) / den;
+    return 20.0 * std::log10(std::abs(AF_norm));
+}
+
+void Receiver::calc_SNR_channels(const Satellite& sat, std::vector<double>& snr_dB) {
+    checkChannelPlan(sat);
+    const RecParams& p = params();
+    const ChannelPlan& rx = *p.channels;
+    const ChannelPlan& tx = sat.getChannelPlan();
+    std::size_t K = rx.size();
+    snr_dB.resize(K);
+
+    // frequency independent terms
+    double range_dB = 20.0 * std::log10(sat.recToSat(rec_pos).magnitude_m());
+    // boresight gains are at each end's carrier, the plan constants at its f_ref
+    double base = sat.getSp() + 30 + sat.getGt_dBi() + p.Gr_dBi - range_dB
+                + tx.refShift_dB(sat.getFc()) + rx.refShift_dB(p.fc)
+                - (10.0 * std::log10(g_K * p.T0) + 30 + p.nf);
+
+    const double* tx_B = tx.bandwidth_dB().data();
+    const double* rx_B = rx.bandwidth_dB().data();
+    const double* tx_gain = tx.apertureGain_dB().data();
+    const double* rx_gain = rx.apertureGain_dB().data();
+    const double* fspl = rx.fsplConst_dB().data();
+    double* out = snr_dB.data();
+    for (std::size_t k = 0; k < K; ++k) {
+        // Ptx + Gtx + Grx - L - Pn, both apertures scale with frequency
+        out[k] = base + tx_B[k] + tx_gain[k] + rx_gain[k] - fspl[k] - rx_B[k];
+    }
+}
+
+void Receiver::calc_INR_channels(const Satellite& in_sat, const Satellite& out_sat, std::vector<double>& inr_dB) {
+    checkChannelPlan(out_sat);
+    const RecParams& p = params();
+    const ChannelPlan& rx = *p.channels;
+    const ChannelPlan& tx = out_sat.getChannelPlan();
+    std::size_t K = rx.size();
+    inr_dB.resize(K);
+
+    // frequency independent terms
+    double range_dB = 20.0 * std::log10(out_sat.recToSat(rec_pos).magnitude_m());
+    double sin_t = std::sin(calc_sat_int_angle(out_sat));
+    double sin_r = std::sin(calc_rec_int_angle(in_sat, out_sat));
+    double base = out_sat.getSp() + 30 + out_sat.getGt_dBi() + p.Gr_dBi - range_dB
+                + tx.refShift_dB(out_sat.getFc()) + rx.refShift_dB(p.fc)
+                - (10.0 * std::log10(g_K * p.T0) + 30 + p.nf);
+    // phase scale fc_k / f_ref -> fc_k / carrier of each array
+    double tx_phase = tx.getRefFc() / out_sat.getFc();
+    double rx_phase = rx.getRefFc() / p.fc;
+
+    const double* tx_B = tx.bandwidth_dB().data();
+    const double* rx_B = rx.bandwidth_dB().data();
+    const double* tx_gain = tx.apertureGain_dB().data();
+    const double* rx_gain = rx.apertureGain_dB().data();
+    const double* fspl = rx.fsplConst_dB().data();
+    const double* tx_scale = tx.phaseScale().data();
+    const double* rx_scale = rx.phaseScale().data();
+    double* out = inr_dB.data();
+    for (std::size_t k = 0; k < K; ++k) {
+        double AF_dB = channelAF_dB(sin_t, tx_scale[k] * tx_phase, p.M)
+                     + channelAF_dB(sin_r, rx_scale[k] * rx_phase, p.N);
+        out[k] = base + tx_B[k] + tx_gain[k] + rx_gain[k] + AF_dB - fspl[k] - rx_B[k];
+    }
+}
+
+void Receiver::calc_link_channels(const Satellite& in_sat, const Satellite& out_sat,
+                                  std::vector<double>& snr_dB, std::vector<double>& inr_dB, std::vector<double>& sinr_dB) {
+    calc_SNR_channels(in_sat, snr_dB);
+    calc_INR_channels(in_sat, out_sat, inr_dB);
+    calc_SINR_channels(snr_dB, inr_dB, sinr_dB);
+}
+
+void Receiver::calc_SINR_channels(const std::vector<double>& snr_dB, const std::vector<double>& inr_dB,
+                                  std::vector<double>& sinr_dB) {
+    std::size_t K = snr_dB.size();
+    sinr_dB.resize(K);
+    for (std::size_t k = 0; k < K; ++k) {
+        sinr_dB[k] = snr_dB[k] - 10.0 * std::log10(1.0 + std::pow(10.0, inr_dB[k]/10.0));
+    }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #pragma once
 #include<vector>
 #include "Satellite.hpp"
+#include "Candidates.hpp"
 
 class Receiver {
     public:
@@ -22,18 +23,31 @@ class Receiver {
     int getRecID() const;
     Vec2 getRecPos() const;
     Satellite& getInSysSat();
+    const Satellite& getInSysSat() const;
     Satellite& getOutSysSat();
     double getPr_req_dBm() const;
     double getGr_dBi() const;
+    bool isPaired() const;
+    double getLambda() const;
+    double getArrayDim() const;
+    double getSatArrayDim() const;
+    double getPn_dBm() const;
+    double getSNR_min() const;
+    double getINR_max() const;
+    CandidateList& getCandidates();
+    const CandidateList& getCandidates() const;
 
     void setSysID(int);
     void setRecID(int);
     void setRecPos(Vec2);
     void setRecPos(double, double);
+    void setChannelPlan(std::shared_ptr<const ChannelPlan>);
+    void setParams(RecParamsPtr); // shared record from ParamTable
+    const ChannelPlan& getChannelPlan() const;
+    const RecParams& params() const { return *param; }
 
     void pairSat(Satellite&);
     void setOutSysSat(Satellite&);
-    void calcSignalStuff();
    
     // before / during satellite selection -> no in_sys_sat or out_sys_sat
     double getElevationAngle(Vec2);
@@ -51,13 +65,23 @@ class Receiver {
     double calc_Gr_int_UN(const Satellite&, const Satellite&, int);
     double calc_INR_UN(const Satellite&, const Satellite&, int);
     double calc_SINR_UN(const Satellite&, const Satellite&, int);
+
+    // multi-channel link budget on this receiver's channel plan, one value per channel in dB
+    // geometry (range, angles) is evaluated once and shared by every channel
+    void calc_SNR_channels(const Satellite&, std::vector<double>&);
+    void calc_INR_channels(const Satellite&, const Satellite&, std::vector<double>&);
+    void calc_link_channels(const Satellite&, const Satellite&,
+                            std::vector<double>&, std::vector<double>&, std::vector<double>&);
+    // SINR per channel from SNR and INR per channel, lets a fixed SNR be reused
+    static void calc_SINR_channels(const std::vector<double>&, const std::vector<double>&, std::vector<double>&);
     
     private:
     int sys_id;
     int rec_id;
     Vec2 rec_pos; // km
     //int rec_type;
-    double N; // NxN antenna array
+    // terminal class (array size, signal stuff) shared across receivers, see RecParams
+    RecParamsPtr param;
     
     Satellite in_sys_sat;
     Vec2 in_sys_rel_pos; // km
@@ -71,20 +95,8 @@ class Receiver {
     double out_sys_dist; // meters
     bool out_sys_sat_def;
 
-    // signal stuff
-    double lambda;
-    double Gr_dBi;      // boresight receive gain in dBi
-    double Gr_lin;      // boresight receive gain linear
-    double Aeff;        // effective area of receiver
-    double Pn_dBm;      // noise power in dBm
-    double Pr_req_dBm;  // minimum required receive power
-    
-    double fc = 20e9; // Hz
-    double B = 400e6; // Hz
-    double M = 64; // satellite array dimension
-    double eta = 0.6;
-    double T0 = 290; // noise temperature K
-    double nf = 1.2; // noise figure dB
-    double SNR_min = 25; // minimum threshold for signal to noise ratio dB
-    double INR_max = -12.2; // threshold for prohibitive interference
+    // ranked alternatives from the last selection pass, best first
+    CandidateList candidates;
+
+    void checkChannelPlan(const Satellite&) const;
 };
\ No newline at end of file
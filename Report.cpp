@@ -0,0 +1,112 @@
+/*
+ * File: Report.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: DataReport class implementation
+ *              Column-selective, lazily evaluated per-satellite data table
+ * */
+
+#include<algorithm>
+#include<cmath>
+
+#include "Report.hpp"
+
+DataReport::DataReport(const std::vector<Satellite>& sys1_sats_, const std::vector<Satellite>& sys2_sats_,
+                       const Receiver& U_rec_, const Receiver& V_rec_, const std::vector<Column>& columns_)
+    : sys1_sats(sys1_sats_), sys2_sats(sys2_sats_), U_rec(U_rec_), V_rec(V_rec_), columns(columns_) {
+    P_sat = U_rec.getInSysSat();
+    S_sat = V_rec.getInSysSat();
+    row = 0;
+    n1 = sys1_sats.size();
+    n2 = sys2_sats.size();
+    for (Column c : columns) {
+        wanted[int(c)] = true;
+    }
+
+    // hoist terms that do not depend on the row index
+    inr_pv_dB = wanted[int(Column::INR_pv)] ? V_rec.calc_INR(S_sat, P_sat) : 0;
+    snr_U_P_dB = wanted[int(Column::SINR1)] ? U_rec.calc_SNR(P_sat) : 0;
+    snr_V_S_dB = wanted[int(Column::SINR2)] ? V_rec.calc_SNR(S_sat) : 0;
+}
+
+std::vector<Column> DataReport::allColumns() {
+    std::vector<Column> cols;
+    for (int c = 0; c < g_num_columns; ++c) {
+        cols.push_back(Column(c));
+    }
+    return cols;
+}
+
+// same combination as Receiver::calc_SINR with the SNR term precomputed
+static double combineSINR(double snr_dB, double inr_dB) {
+    return snr_dB - 10.0 * std::log10(1.0 + std::pow(10.0, inr_dB/10.0));
+}
+
+bool DataReport::next(ReportRow& out) {
+    if (row >= std::max(n1, n2)) {
+        return false;
+    }
+    int i = row++;
+    out.index = i;
+    out.present.fill(false);
+
+    auto set = [&out](Column c, double v) {
+        out.values[int(c)] = v;
+        out.present[int(c)] = true;
+    };
+
+    if (i < n1) {
+        const Satellite& sat = sys1_sats[i];
+        if (wanted[int(Column::Sys1Range)]) {
+            set(Column::Sys1Range, sat.getSatPos().x);
+        }
+        if (wanted[int(Column::SNR1)]) {
+            set(Column::SNR1, U_rec.calc_SNR(sat));
+        }
+        if (wanted[int(Column::INR_pv)]) {
+            set(Column::INR_pv, inr_pv_dB);
+        }
+        if (wanted[int(Column::SINR2)]) {
+            set(Column::SINR2, combineSINR(snr_V_S_dB, V_rec.calc_INR(S_sat, sat)));
+        }
+    }
+    if (i < n2) {
+        const Satellite& sat = sys2_sats[i];
+        if (wanted[int(Column::Sys2Range)]) {
+            set(Column::Sys2Range, sat.getSatPos().x);
+        }
+        if (wanted[int(Column::SNR2)]) {
+            set(Column::SNR2, V_rec.calc_SNR(sat));
+        }
+        // INR_su feeds SINR1, only evaluate it once per row
+        bool need_inr = wanted[int(Column::INR_su)] || wanted[int(Column::SINR1)];
+        double inr_su_dB = need_inr ? U_rec.calc_INR(P_sat, sat) : 0;
+        if (wanted[int(Column::INR_su)]) {
+            set(Column::INR_su, inr_su_dB);
+        }
+        if (wanted[int(Column::SINR1)]) {
+            set(Column::SINR1, combineSINR(snr_U_P_dB, inr_su_dB));
+        }
+        if (wanted[int(Column::IntAngle)]) {
+            set(Column::IntAngle, U_rec.calc_rec_int_angle(P_sat, sat) * 180 / g_PI);
+        }
+    }
+    return true;
+}
+
+void DataReport::write(std::ostream& out) {
+    ReportRow r;
+    while (next(r)) {
+        writeRow(out, r);
+    }
+}
+
+void DataReport::writeRow(std::ostream& out, const ReportRow& r) const {
+    out << r.index;
+    for (Column c : columns) {
+        out << ',';
+        if (r.has(c)) {
+            out << r.get(c);
+        }
+    }
+    out << '\n';
+}
@@ -0,0 +1,73 @@
+/*
+ * File: Report.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for DataReport class
+ *              Column-selective, lazily evaluated per-satellite data table
+ * */
+
+#pragma once
+#include<array>
+#include<ostream>
+#include<vector>
+
+#include "Receiver.hpp"
+
+// columns of the calc_data table, in output order
+enum class Column
+{
+    Sys1Range,  // x position of sys1_sats[i]
+    SNR1,       // SNR(U, sys1_sats[i])
+    INR_pv,     // INR by P on V
+    SINR2,      // SINR(V, S; sys1_sats[i])
+    Sys2Range,  // x position of sys2_sats[i]
+    SNR2,       // SNR(V, sys2_sats[i])
+    INR_su,     // INR(U, P; sys2_sats[i])
+    SINR1,      // SINR(U, P; sys2_sats[i])
+    IntAngle    // angle at U between P and sys2_sats[i], degrees
+};
+
+const int g_num_columns = 9;
+
+struct ReportRow
+{
+    int index;
+    std::array<double, g_num_columns> values;
+    std::array<bool, g_num_columns> present;
+
+    bool has(Column c) const { return present[int(c)]; }
+    double get(Column c) const { return values[int(c)]; }
+};
+
+class DataReport {
+    public:
+    // U/P: primary receiver and its satellite, V/S: secondary receiver and its satellite
+    DataReport(const std::vector<Satellite>&, const std::vector<Satellite>&,
+               const Receiver&, const Receiver&, const std::vector<Column>&);
+
+    // full table, all columns
+    static std::vector<Column> allColumns();
+
+    // produce the next row, false once the table is exhausted
+    bool next(ReportRow&);
+    // stream every remaining row as comma separated text
+    void write(std::ostream&);
+    // one row as written by write()
+    void writeRow(std::ostream&, const ReportRow&) const;
+
+    private:
+    const std::vector<Satellite>& sys1_sats;
+    const std::vector<Satellite>& sys2_sats;
+    Receiver U_rec;
+    Receiver V_rec;
+    Satellite P_sat;
+    Satellite S_sat;
+    std::vector<Column> columns;
+    std::array<bool, g_num_columns> wanted{};
+    int row;
+    int n1, n2;
+
+    // loop-invariant terms, computed once in the constructor when needed
+    double inr_pv_dB;
+    double snr_U_P_dB;
+    double snr_V_S_dB;
+};
@@ -6,22 +6,51 @@
  * */
 
 #include<cmath>
+#include<stdexcept>
 
 #include "Satellite.hpp"
 
+// record for a system, interned so every satellite of the system shares it
+static SatParamsPtr systemClass(const SystemParams& sys) {
+    SatParams params;
+    params.sys_id = sys.sys_id;
+    params.Sp = sys.Sp;
+    return ParamTable::sat(params);
+}
+
 Satellite::Satellite(int sys_id_, int sat_id_, Vec2 pos_) {
     sys_id = sys_id_;
     sat_id = sat_id_;
     in_use = false;
     sat_pos_defined = true;
     sat_pos = pos_;
-    calcSignalStuff();
+    param = systemClass(defaultSystemParams(sys_id));
+}
+
+Satellite::Satellite(int sys_id_, int sat_id_, Vec2 pos_, const SystemParams& params) {
+    sys_id = sys_id_;
+    sat_id = sat_id_;
+    in_use = false;
+    sat_pos_defined = true;
+    sat_pos = pos_;
+    param = systemClass(params);
+}
+
+Satellite::Satellite(int sys_id_, int sat_id_, Vec2 pos_, SatParamsPtr param_) {
+    sys_id = sys_id_;
+    sat_id = sat_id_;
+    in_use = false;
+    sat_pos_defined = true;
+    sat_pos = pos_;
+    param = std::move(param_);
 }
 
 Satellite::Satellite() {
     sys_id = 0;
     sat_id = 0;
+    in_use = false;
     sat_pos_defined = false;
+    param = ParamTable::defaultSat();
     sat_pos = Vec2();
 }
 
@@ -37,17 +66,23 @@ Vec2 Satellite::getSatPos() const { return sat_pos; }
 
 Vec2 Satellite::getSatDir() const { return sat_direction; }
 
-double Satellite::getFc() const { return fc; }
+double Satellite::getFc() const { return params().fc; }
+
+double Satellite::getB() const { return params().bandwidth; }
+
+double Satellite::getGtLin() const { return params().Gt_lin; }
 
-double Satellite::getB() const { return bandwidth; }
+double Satellite::getGt_dBi() const { return params().Gt_dBi; }
 
-double Satellite::getGtLin() const { return Gt_lin; }
+double Satellite::getPt_dBW() const { return params().Pt_dBW; }
 
-double Satellite::getGt_dBi() const { return Gt_dBi; }
+double Satellite::getPt_dBm() const { return params().Pt_dBW + 30; }
 
-double Satellite::getPt_dBW() const { return Pt_dBW; }
+double Satellite::getEIRP_mW() const { return params().EIRP_mW; }
 
-double Satellite::getPt_dBm() const { return Pt_dBW + 30; }
+double Satellite::getSp() const { return params().Sp; }
+
+const ChannelPlan& Satellite::getChannelPlan() const { return *params().channels; }
 
 bool Satellite::inUse() const { return in_use; }
 
@@ -81,6 +116,25 @@ void Satellite::aimSat(Vec2 pos) {
     sat_direction = pos - sat_pos;
 }
 
+void Satellite::setSpectralDensity(double Sp_) {
+    SatParams p = params();
+    p.Sp = Sp_;
+    param = ParamTable::sat(p);
+}
+
+void Satellite::setChannelPlan(std::shared_ptr<const ChannelPlan> plan) {
+    if (!plan->fitsBand(getFc(), getB())) {
+        throw std::runtime_error{"channel plan outside the satellite band"};
+    }
+    SatParams p = params();
+    p.channels = plan;
+    param = ParamTable::sat(p);
+}
+
+void Satellite::setParams(SatParamsPtr param_) {
+    param = std::move(param_);
+}
+
 Vec2 Satellite::recToSat(Vec2 rec_pos) const {
     return sat_pos-rec_pos;
 }
@@ -100,25 +154,4 @@ std::string Satellite::toString() const {
     std::string s = oss.str();
     
     return s;
-}
-
-void Satellite::calcSignalStuff() {
-    lambda = g_C / fc; // wavelength
-    double dx = 0.5 * lambda; // half-wave spacing
-    double dy = dx;
-    A = (M*dx)*(N*dy); // aperature area
-    Gt_lin = eta * (4.0 * g_PI * A) / (lambda*lambda); // linear transmit gain
-    Gt_dBi = 10.0 * std::log10(Gt_lin); // transmit gain dBi ~38.8 ish
-
-    switch(sys_id) {
-        case 1:
-            Sp = -54.3;
-            break;
-        case 2:
-            Sp = -53.3;
-            break;
-        default:
-            std::cerr << "Warning: unknown sys_id\n";
-    }
-    Pt_dBW = Sp + 10.0 * std::log10(bandwidth);
 }
\ No newline at end of file
@@ -7,16 +7,21 @@
 
 #pragma once
 
+#include<cstdint>
 #include<iostream>
 #include<string>
 #include<sstream>
 
 #include "MyUtil.hpp"
+#include "SystemParams.hpp"
+#include "Params.hpp"
 
 class Satellite {
     public:
     // Constructors
     Satellite(int, int, Vec2);
+    Satellite(int, int, Vec2, const SystemParams&);
+    Satellite(int, int, Vec2, SatParamsPtr); // shared record from ParamTable
     Satellite();
 
     ~Satellite();
@@ -33,12 +38,19 @@ class Satellite {
     double getGt_dBi() const;
     double getPt_dBW() const;
     double getPt_dBm() const;
+    double getEIRP_mW() const;
+    double getSp() const;
+    const ChannelPlan& getChannelPlan() const;
+    const SatParams& params() const { return *param; }
 
     void setSysID(int);
     void setSatID(int);
     void setSatPos(double, double);
     void setSatPos(Vec2);
     void aimSat(Vec2);
+    void setSpectralDensity(double);
+    void setChannelPlan(std::shared_ptr<const ChannelPlan>);
+    void setParams(SatParamsPtr);
     
     bool inUse() const;
     void activate();
@@ -48,7 +60,6 @@ class Satellite {
     Vec2 satToRec(Vec2) const;
     
     std::string toString() const;
-    void calcSignalStuff();
 
     private:
     // ID of system satellite is part of
@@ -57,19 +68,8 @@ class Satellite {
     int sat_id;
     bool sat_pos_defined;
     bool in_use;
+    // signal stuff shared across the system, see SatParams
+    SatParamsPtr param;
     Vec2 sat_pos; // km
     Vec2 sat_direction; // vector towards paired receiver
-    
-    // signal stuff
-    double Gt_dBi; // boresight transmit gain dBi
-    double Gt_lin; // boresight transmit gain linear
-    double Pt_dBW;
-    double fc = 20e9; //Hz
-    double bandwidth = 400e6; // Hz
-    double lambda;
-    double A;
-    double eta = 0.6; // aperture efficiency
-    int M = 64, N = 64; // 64x64 antenna array
-    double Sp;
-    double EIRP_dBm;
 };
\ No newline at end of file
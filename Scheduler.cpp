@@ -0,0 +1,216 @@
+/*
+ * File: Scheduler.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: Scheduler class implementation
+ *              Discrete event executor for C++20 coroutine agents
+ * */
+
+#include<algorithm>
+#include<cmath>
+
+#include "Scheduler.hpp"
+#include "Parallel.hpp"
+
+Scheduler::Scheduler(unsigned threads_, double tick_) {
+    threads = workerCount(threads_);
+    tick = tick_;
+    t_now = 0;
+    resumes = 0;
+    timer_seq = 0;
+    // the run loop is the last worker
+    for (unsigned k = 1; k < threads; ++k) {
+        pool.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    batch_ready.notify_all();
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    // suspended and finished frames alike are released here
+    for (AgentHandle h : frames) {
+        h.destroy();
+    }
+}
+
+void Scheduler::drain() {
+    for (std::size_t k = next_item.fetch_add(1); k < work_size; k = next_item.fetch_add(1)) {
+        work[k].resume();
+    }
+}
+
+void Scheduler::workerLoop() {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    while (true) {
+        batch_ready.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        lock.unlock();
+        drain();
+        lock.lock();
+        if (--busy == 0) {
+            batch_done.notify_one();
+        }
+    }
+}
+
+void Scheduler::resumeBatch(std::vector<AgentHandle>& batch) {
+    // wake-ups arrive in thread order, spawn order makes the batch the same every run
+    std::sort(batch.begin(), batch.end(), [](AgentHandle a, AgentHandle b) {
+        const AgentTask::promise_type& pa = a.promise();
+        const AgentTask::promise_type& pb = b.promise();
+        return pa.phase < pb.phase || (pa.phase == pb.phase && pa.id < pb.id);
+    });
+    std::size_t begin = 0;
+    while (begin < batch.size()) {
+        std::size_t end = begin + 1;
+        while (end < batch.size() && batch[end].promise().phase == batch[begin].promise().phase) {
+            ++end;
+        }
+        resumePhase(batch.data() + begin, end - begin);
+        begin = end;
+    }
+}
+
+void Scheduler::resumePhase(const AgentHandle* agents, std::size_t n) {
+    // a lone agent is cheaper to run than to hand over
+    if (pool.empty() || n == 1) {
+        for (std::size_t k = 0; k < n; ++k) {
+            agents[k].resume();
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        work = agents;
+        work_size = n;
+        next_item.store(0);
+        busy = pool.size();
+        ++generation;
+    }
+    batch_ready.notify_all();
+    drain();
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    batch_done.wait(lock, [&]() { return busy == 0; });
+    work = nullptr;
+}
+
+void Scheduler::spawn(AgentTask task, int phase) {
+    task.handle.promise().phase = phase;
+    task.handle.promise().id = frames.size();
+    frames.push_back(task.handle);
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    ready.push_back(task.handle);
+}
+
+void Scheduler::addTimer(double t, std::shared_ptr<Waiter> waiter) {
+    t = std::max(t, t_now);
+    if (tick > 0) {
+        // rounded up, an agent never wakes before the time it asked for
+        t = std::max(t_now, std::ceil(t / tick) * tick);
+    }
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    timers.push(Timer{t, timer_seq++, std::move(waiter)});
+}
+
+bool Scheduler::wake(const std::shared_ptr<Waiter>& waiter, int reason) {
+    int pending = -1;
+    if (!waiter->reason.compare_exchange_strong(pending, reason)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    ready.push_back(waiter->handle);
+    return true;
+}
+
+void Scheduler::SleepAwaiter::await_suspend(AgentHandle h) {
+    std::shared_ptr<Waiter> waiter = std::make_shared<Waiter>();
+    waiter->handle = h;
+    sched.addTimer(t, std::move(waiter));
+}
+
+void Scheduler::EventAwaiter::await_suspend(AgentHandle h) {
+    waiter = std::make_shared<Waiter>();
+    waiter->handle = h;
+    sched.addTimer(t, waiter);
+    for (Event* ev : events) {
+        ev->add(sched, waiter);
+    }
+}
+
+void Scheduler::run(double t_end) {
+    std::vector<AgentHandle> batch;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(ready_mutex);
+            batch.swap(ready);
+        }
+        if (batch.empty()) {
+            // advance virtual time to the next timer, dropping waiters an event already woke
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            while (!timers.empty() && timers.top().waiter->reason.load() != -1) {
+                timers.pop();
+            }
+            if (timers.empty() || timers.top().t > t_end) {
+                break;
+            }
+            t_now = timers.top().t;
+            while (!timers.empty() && timers.top().t == t_now) {
+                Timer timer = timers.top();
+                timers.pop();
+                int pending = -1;
+                if (timer.waiter->reason.compare_exchange_strong(pending, 0)) {
+                    batch.push_back(timer.waiter->handle);
+                }
+            }
+            continue;
+        }
+
+        // agents due at t_now run concurrently within their phase, wake-ups they cause land in the next batch
+        resumes += batch.size();
+        resumeBatch(batch);
+        batch.clear();
+    }
+}
+
+void Event::set(Scheduler& sched) {
+    std::vector<std::shared_ptr<Scheduler::Waiter>> woken;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        woken.swap(waiters);
+    }
+    for (const auto& waiter : woken) {
+        sched.wake(waiter, 1);
+    }
+}
+
+void Event::latch(Scheduler& sched) {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        latched = true;
+    }
+    set(sched);
+}
+
+void Event::add(Scheduler& sched, std::shared_ptr<Scheduler::Waiter> waiter) {
+    std::unique_lock<std::mutex> lock(m);
+    if (latched) {
+        lock.unlock();
+        // resumed in the next batch, after the caller has finished suspending
+        sched.wake(waiter, 1);
+        return;
+    }
+    // waiters that timed out are never woken by this event, drop them
+    if (waiters.size() >= 8) {
+        std::erase_if(waiters, [](const auto& w) { return w->reason.load() != -1; });
+    }
+    waiters.push_back(std::move(waiter));
+}
@@ -0,0 +1,162 @@
+/*
+ * File: Scheduler.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for Scheduler class
+ *              Discrete event executor for C++20 coroutine agents
+ * */
+
+#pragma once
+#include<atomic>
+#include<condition_variable>
+#include<coroutine>
+#include<exception>
+#include<memory>
+#include<mutex>
+#include<queue>
+#include<thread>
+#include<vector>
+
+/*
+ * coroutine type for an agent
+ * starts suspended, the scheduler resumes it once spawned and owns the
+ * frame until the scheduler is destroyed
+ * */
+struct AgentTask
+{
+    struct promise_type
+    {
+        int phase = 0;       // set by Scheduler::spawn
+        std::size_t id = 0;  // spawn order
+
+        AgentTask get_return_object() {
+            return AgentTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+using AgentHandle = std::coroutine_handle<AgentTask::promise_type>;
+
+class Event;
+
+class Scheduler {
+    public:
+    // suspended agent, woken once by whichever timer or event fires first
+    struct Waiter
+    {
+        AgentHandle handle;
+        std::atomic<int> reason{-1}; // -1 pending, 0 timer, 1 event
+    };
+
+    /*
+    * threads - 1 workers are started once and reused for every batch
+    * tick > 0 rounds wake-up times up to a multiple of tick so agents due
+    * within the same tick are resumed in one batch, 0 keeps exact times
+    *
+    * a batch runs phase by phase in increasing order with a barrier in
+    * between, agents of one phase run concurrently and must not read what
+    * other agents of the same phase write; then the results do not depend
+    * on the thread count or interleaving
+    * */
+    explicit Scheduler(unsigned threads = 0, double tick = 0);
+    ~Scheduler();
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    void spawn(AgentTask, int phase = 0);
+    // process every wake-up up to and including t_end, in time order
+    void run(double);
+    double now() const { return t_now; }
+    std::size_t resumeCount() const { return resumes; }
+
+    // wake a waiter at the current time, false if it already fired
+    bool wake(const std::shared_ptr<Waiter>&, int);
+
+    // co_await sleepUntil(t): resume at virtual time t
+    struct SleepAwaiter
+    {
+        Scheduler& sched;
+        double t;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(AgentHandle);
+        void await_resume() const noexcept {}
+    };
+    SleepAwaiter sleepUntil(double t) { return SleepAwaiter{*this, t}; }
+    SleepAwaiter sleepFor(double dt) { return SleepAwaiter{*this, t_now + dt}; }
+
+    // co_await waitAny(events, dt): true if an event fired, false on timeout
+    struct EventAwaiter
+    {
+        Scheduler& sched;
+        std::vector<Event*> events;
+        double t;
+        std::shared_ptr<Waiter> waiter;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(AgentHandle);
+        bool await_resume() const noexcept { return waiter->reason.load() == 1; }
+    };
+    EventAwaiter waitAny(std::vector<Event*> events, double dt) {
+        return EventAwaiter{*this, std::move(events), t_now + dt, nullptr};
+    }
+
+    private:
+    struct Timer
+    {
+        double t;
+        std::size_t seq; // FIFO among equal times
+        std::shared_ptr<Waiter> waiter;
+        bool operator>(const Timer& o) const { return t > o.t || (t == o.t && seq > o.seq); }
+    };
+
+    unsigned threads;
+    double tick;
+    double t_now;
+    std::size_t resumes;
+    std::size_t timer_seq;
+    std::vector<AgentHandle> frames; // every spawned agent, destroyed with the scheduler
+
+    std::mutex timer_mutex;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::mutex ready_mutex;
+    std::vector<AgentHandle> ready; // resumed in the next batch at t_now
+
+    // persistent workers, the run loop hands them one batch at a time
+    std::vector<std::thread> pool;
+    std::mutex pool_mutex;
+    std::condition_variable batch_ready;
+    std::condition_variable batch_done;
+    const AgentHandle* work = nullptr; // current phase of the batch
+    std::size_t work_size = 0;
+    std::atomic<std::size_t> next_item{0};
+    std::size_t generation = 0; // batches handed out so far
+    std::size_t busy = 0;       // workers still in the current batch
+    bool stopping = false;
+
+    void addTimer(double, std::shared_ptr<Waiter>);
+    void resumeBatch(std::vector<AgentHandle>&);
+    void resumePhase(const AgentHandle*, std::size_t);
+    void drain();
+    void workerLoop();
+};
+
+/*
+ * one-shot broadcast: set() wakes every agent currently waiting on it
+ * waiters registering after set() wait for the next set() or their timeout
+ * latch() is a set() that stays set: later waiters are woken right away,
+ * for permanent state changes an agent may miss while it is running
+ * */
+class Event {
+    public:
+    void set(Scheduler&);
+    void latch(Scheduler&);
+    void add(Scheduler&, std::shared_ptr<Scheduler::Waiter>);
+
+    private:
+    std::mutex m;
+    bool latched = false;
+    std::vector<std::shared_ptr<Scheduler::Waiter>> waiters;
+};
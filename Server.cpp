@@ -0,0 +1,453 @@
+/*
+ * File: Server.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: QueryServer class implementation
+ *              Answers link queries against a loaded SoS over a Unix-domain socket
+ * */
+
+#include<cerrno>
+#include<cstring>
+#include<iostream>
+#include<sstream>
+#include<stdexcept>
+
+#include<fcntl.h>
+#include<poll.h>
+#include<sys/socket.h>
+#include<sys/stat.h>
+#include<sys/un.h>
+#include<unistd.h>
+
+#include "Server.hpp"
+#include "Parallel.hpp"
+
+// batches smaller than this are not worth starting threads for
+static const std::size_t g_parallel_batch = 512;
+// a client sending a longer line without a newline is dropped
+static const std::size_t g_max_line = 4096;
+
+static void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// only sockets are ever unlinked, anything else at the path belongs to someone else
+static bool isSocket(const std::string& path) {
+    struct stat st;
+    return lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode);
+}
+
+QueryServer::QueryServer(SoS& s, const std::string& socket_path, unsigned thread_count)
+    : sos(s), path(socket_path), threads(thread_count), listen_fd(-1), stopping(false) {
+    buildIndex();
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error{"socket path too long: " + path};
+    }
+    std::strcpy(addr.sun_path, path.c_str());
+
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            throw std::runtime_error{"refusing to replace " + path + ": exists and is not a socket"};
+        }
+        unlink(path.c_str()); // stale socket from an earlier run
+    }
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error{std::string("socket: ") + std::strerror(errno)};
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || listen(listen_fd, 64) < 0) {
+        std::string err = std::strerror(errno);
+        close(listen_fd);
+        throw std::runtime_error{"could not listen on " + path + ": " + err};
+    }
+    setNonBlocking(listen_fd);
+}
+
+QueryServer::~QueryServer() {
+    for (Client& c : clients) {
+        close(c.fd);
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        if (isSocket(path)) {
+            unlink(path.c_str());
+        }
+    }
+}
+
+void QueryServer::buildIndex() {
+    const std::vector<System>& systems = sos.systemList();
+    sys_index.clear();
+    rec_index.assign(systems.size(), {});
+    sat_index.assign(systems.size(), {});
+    kernels.assign(systems.size(), {});
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        sys_index[systems[k].params.sys_id] = k;
+        for (std::size_t i = 0; i < systems[k].recs.size(); ++i) {
+            rec_index[k][systems[k].recs[i].getRecID()] = i;
+            kernels[k].emplace_back(systems[k].recs[i]);
+        }
+        for (std::size_t i = 0; i < systems[k].sats.size(); ++i) {
+            sat_index[k][systems[k].sats[i].getSatID()] = i;
+        }
+    }
+}
+
+QueryServer::Request QueryServer::parse(const std::string& line, int client) const {
+    Request req{client, Op::Bad, -1, -1, -1, -1, ""};
+    std::istringstream in(line);
+    std::string cmd;
+    in >> cmd;
+
+    auto lookup = [](const std::unordered_map<int, int>& m, int id) {
+        auto it = m.find(id);
+        return it == m.end() ? -1 : it->second;
+    };
+    auto findSys = [&](int id) { return lookup(sys_index, id); };
+
+    if (cmd == "QUIT") {
+        req.op = Op::Quit;
+        return req;
+    }
+    if (cmd == "SHUTDOWN") {
+        req.op = Op::Shutdown;
+        return req;
+    }
+    if (cmd == "SELECT") {
+        int mode;
+        if (!(in >> mode) || mode < 1 || mode > 3) {
+            req.reply = "ERR usage: SELECT <1|2|3>";
+            return req;
+        }
+        req.op = Op::Select;
+        req.sys = mode;
+        return req;
+    }
+
+    Op op;
+    bool interferer;
+    if (cmd == "SNR") {
+        op = Op::SNR;
+        interferer = false;
+    } else if (cmd == "FEASIBLE") {
+        op = Op::Feasible;
+        interferer = false;
+    } else if (cmd == "INR") {
+        op = Op::INR;
+        interferer = true;
+    } else if (cmd == "SINR") {
+        op = Op::SINR;
+        interferer = true;
+    } else {
+        req.reply = "ERR unknown command";
+        return req;
+    }
+
+    int sys_id, rec_id, sat_sys_id, sat_id;
+    if (!(in >> sys_id >> rec_id)) {
+        req.reply = "ERR missing receiver";
+        return req;
+    }
+    if (interferer) {
+        if (!(in >> sat_sys_id >> sat_id)) {
+            req.reply = "ERR missing interfering satellite";
+            return req;
+        }
+    } else {
+        sat_sys_id = sys_id;
+        if (!(in >> sat_id)) {
+            req.reply = "ERR missing satellite";
+            return req;
+        }
+    }
+
+    req.sys = findSys(sys_id);
+    req.sat_sys = findSys(sat_sys_id);
+    if (req.sys < 0 || req.sat_sys < 0) {
+        req.reply = "ERR unknown system";
+        return req;
+    }
+    req.rec = lookup(rec_index[req.sys], rec_id);
+    req.sat = lookup(sat_index[req.sat_sys], sat_id);
+    if (req.rec < 0) {
+        req.reply = "ERR unknown receiver";
+        return req;
+    }
+    if (req.sat < 0) {
+        req.reply = "ERR unknown satellite";
+        return req;
+    }
+    req.op = op;
+    return req;
+}
+
+// one link query, read-only on the scenario so batches can run in parallel
+void QueryServer::answer(Request& req) const {
+    const std::vector<System>& systems = sos.systemList();
+    const Receiver& rec = systems[req.sys].recs[req.rec];
+    const Satellite& sat = systems[req.sat_sys].sats[req.sat];
+    const LinkKernel& link = kernels[req.sys][req.rec];
+    std::ostringstream out;
+    out.precision(10);
+
+    switch (req.op) {
+        case Op::SNR:
+            out << "OK " << LinkKernel::to_dB(link.snr_lin(sat));
+            break;
+        case Op::INR:
+        case Op::SINR: {
+            if (!rec.isPaired()) {
+                req.reply = "ERR receiver not paired";
+                return;
+            }
+            const Satellite& in_sat = rec.getInSysSat();
+            double v = req.op == Op::INR ? link.inr_lin(in_sat, sat) : link.sinr_lin(in_sat, sat);
+            out << "OK " << LinkKernel::to_dB(v);
+            break;
+        }
+        case Op::Feasible: {
+            bool ok = link.visible(sat) && link.snr_lin(sat) >= link.snrMin_lin();
+            for (std::size_t k = 0; ok && k < systems.size(); ++k) {
+                if (k == static_cast<std::size_t>(req.sys)) {
+                    continue;
+                }
+                for (std::size_t i = 0; ok && i < systems[k].recs.size(); ++i) {
+                    const Receiver& other = systems[k].recs[i];
+                    if (other.isPaired()) {
+                        const LinkKernel& o = kernels[k][i];
+                        ok = o.inr_lin(other.getInSysSat(), sat) < o.inrMax_lin();
+                    }
+                }
+            }
+            out << "OK " << (ok ? 1 : 0);
+            break;
+        }
+        default:
+            return;
+    }
+    req.reply = out.str();
+}
+
+void QueryServer::evaluate(std::vector<Request>& batch, std::size_t begin, std::size_t end) const {
+    auto body = [&](std::size_t b, std::size_t e) {
+        for (std::size_t i = begin + b; i < begin + e; ++i) {
+            if (batch[i].reply.empty()) {
+                answer(batch[i]);
+            }
+        }
+    };
+    std::size_t n = end - begin;
+    if (n < g_parallel_batch) {
+        body(0, n);
+    } else {
+        parallelFor(n, body, threads);
+    }
+}
+
+/*
+ * link queries are order independent between two SELECTs, so each run of
+ * them is evaluated as one batch; SELECT changes pairings and is a barrier
+ * */
+void QueryServer::process(std::vector<Request>& batch) {
+    std::size_t run_start = 0;
+    for (std::size_t i = 0; i <= batch.size(); ++i) {
+        bool barrier = i == batch.size() || batch[i].op == Op::Select
+                    || batch[i].op == Op::Quit || batch[i].op == Op::Shutdown;
+        if (!barrier) {
+            continue;
+        }
+        evaluate(batch, run_start, i);
+        run_start = i + 1;
+        if (i == batch.size()) {
+            break;
+        }
+
+        Request& req = batch[i];
+        if (req.op == Op::Select) {
+            try {
+                sos.runSatelliteSelection(req.sys);
+                std::ostringstream out;
+                out << "OK";
+                for (const System& sys : sos.systemList()) {
+                    for (const Receiver& rec : sys.recs) {
+                        if (rec.isPaired()) {
+                            out << ' ' << sys.params.sys_id << ':' << rec.getRecID()
+                                << ':' << rec.getInSysSat().getSatID();
+                        }
+                    }
+                }
+                req.reply = out.str();
+            } catch (const std::runtime_error& e) {
+                req.reply = std::string("ERR ") + e.what();
+            }
+        } else if (req.op == Op::Quit) {
+            req.reply = "OK";
+            if (req.client >= 0) {
+                clients[req.client].closing = true;
+            }
+        } else {
+            req.reply = "OK";
+            stopping = true;
+        }
+    }
+}
+
+std::string QueryServer::handle(const std::string& line) {
+    std::vector<Request> batch{parse(line, -1)};
+    process(batch);
+    return batch[0].reply;
+}
+
+void QueryServer::acceptClients() {
+    while (true) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return; // EAGAIN, nothing left to accept
+        }
+        setNonBlocking(fd);
+        clients.push_back({fd, "", "", false});
+    }
+}
+
+/*
+ * append every complete line from client k to batch, false on a read error
+ * a client that half-closes (EOF) still gets replies to the lines it sent,
+ * it is marked closing and dropped once they are flushed
+ * */
+bool QueryServer::readClient(std::size_t k, std::vector<Request>& batch) {
+    Client& c = clients[k];
+    if (c.closing) {
+        return true; // hung up while replies are pending, flushClient reports errors
+    }
+    char buf[4096];
+    bool eof = false;
+    while (true) {
+        ssize_t n = read(c.fd, buf, sizeof(buf));
+        if (n > 0) {
+            c.in.append(buf, n);
+            continue;
+        }
+        if (n == 0) {
+            eof = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+
+    std::size_t start = 0;
+    std::size_t nl;
+    while (!c.closing && (nl = c.in.find('\n', start)) != std::string::npos) {
+        std::string line = c.in.substr(start, nl - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        start = nl + 1;
+        if (line.empty()) {
+            continue;
+        }
+        batch.push_back(parse(line, k));
+        if (batch.back().op == Op::Quit) {
+            break; // ignore anything pipelined after QUIT
+        }
+    }
+    c.in.erase(0, start);
+    if (eof) {
+        // last line without a newline still counts, nothing more can follow it
+        if (!c.closing && !c.in.empty() && c.in.size() <= g_max_line) {
+            batch.push_back(parse(c.in, k));
+        }
+        c.in.clear();
+        c.closing = true;
+        return true;
+    }
+    return c.in.size() <= g_max_line;
+}
+
+// false once the client can no longer be written to
+bool QueryServer::flushClient(std::size_t k) {
+    Client& c = clients[k];
+    while (!c.out.empty()) {
+        // MSG_NOSIGNAL, a client that hung up must not take the server down with SIGPIPE
+        ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            c.out.erase(0, n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            // EAGAIN -> wait for POLLOUT
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    return true;
+}
+
+void QueryServer::run() {
+    std::vector<pollfd> fds;
+    std::vector<Request> batch;
+    while (!stopping) {
+        fds.clear();
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (const Client& c : clients) {
+            short events = c.closing ? 0 : POLLIN;
+            if (!c.out.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({c.fd, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error{std::string("poll: ") + std::strerror(errno)};
+        }
+
+        batch.clear();
+        std::vector<bool> dead(clients.size(), false);
+        for (std::size_t k = 0; k < clients.size(); ++k) {
+            short ev = fds[k + 1].revents;
+            if (ev & (POLLIN | POLLHUP | POLLERR)) {
+                if (!readClient(k, batch)) {
+                    dead[k] = true;
+                }
+            }
+        }
+
+        process(batch);
+        for (Request& req : batch) {
+            clients[req.client].out += req.reply;
+            clients[req.client].out += '\n';
+        }
+
+        for (std::size_t k = 0; k < clients.size(); ++k) {
+            if (!flushClient(k) || (clients[k].closing && clients[k].out.empty())) {
+                dead[k] = true;
+            }
+        }
+        // drop finished clients, back to front so slots stay valid
+        for (std::size_t k = clients.size(); k-- > 0;) {
+            if (dead[k]) {
+                close(clients[k].fd);
+                clients.erase(clients.begin() + k);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            acceptClients();
+        }
+    }
+    // best effort so the SHUTDOWN reply reaches its sender
+    for (std::size_t k = 0; k < clients.size(); ++k) {
+        flushClient(k);
+    }
+}
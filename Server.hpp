@@ -0,0 +1,92 @@
+/*
+ * File: Server.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: Header for QueryServer class
+ *              Answers link queries against a loaded SoS over a Unix-domain socket
+ * */
+
+#pragma once
+
+#include<string>
+#include<unordered_map>
+#include<vector>
+
+#include "SoS.hpp"
+#include "LinkKernel.hpp"
+
+/*
+ * line protocol, one request per line, one reply line per request in order
+ * receivers and satellites are named by (sys_id, rec_id / sat_id)
+ *
+ *   SELECT <mode>                          OK <sys>:<rec>:<sat> ...
+ *   SNR <sys> <rec> <sat>                  OK <dB>
+ *   INR <sys> <rec> <int_sys> <int_sat>    OK <dB>   at rec, against its current pairing
+ *   SINR <sys> <rec> <int_sys> <int_sat>   OK <dB>
+ *   FEASIBLE <sys> <rec> <sat>             OK 1|0    visible, SNR >= SNR_min and
+ *                                                    INR < INR_max at every paired
+ *                                                    receiver of the other systems
+ *   QUIT                                   closes this connection
+ *   SHUTDOWN                               stops the server
+ * anything else -> ERR <reason>
+ *
+ * every poll() round drains all readable clients into one batch, link queries
+ * between two SELECTs are evaluated together on the LinkKernels
+ * */
+class QueryServer {
+    public:
+    // scenario must already be built and aimed, threads = 0 -> hardware concurrency
+    QueryServer(SoS&, const std::string&, unsigned threads = 0);
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    // serve until SHUTDOWN
+    void run();
+
+    // answer one request line without a socket, same path as a batch of one
+    std::string handle(const std::string&);
+
+    private:
+    enum class Op { SNR, INR, SINR, Feasible, Select, Quit, Shutdown, Bad };
+
+    struct Request {
+        int client;      // slot in clients, -1 for handle()
+        Op op;
+        int sys;         // index into systemList()
+        int rec;         // index into recs
+        int sat_sys;
+        int sat;         // index into sats
+        std::string reply;
+    };
+
+    struct Client {
+        int fd;
+        std::string in;
+        std::string out;
+        bool closing;
+    };
+
+    SoS& sos;
+    std::string path;
+    unsigned threads;
+    int listen_fd;
+    bool stopping;
+    std::vector<Client> clients;
+
+    // per system: id -> index lookups and one kernel per receiver
+    std::vector<std::unordered_map<int, int>> rec_index;
+    std::vector<std::unordered_map<int, int>> sat_index;
+    std::vector<std::vector<LinkKernel>> kernels;
+    std::unordered_map<int, int> sys_index;
+
+    void buildIndex();
+    Request parse(const std::string&, int) const;
+    void evaluate(std::vector<Request>&, std::size_t, std::size_t) const;
+    void answer(Request&) const;
+    void process(std::vector<Request>&);
+
+    void acceptClients();
+    bool readClient(std::size_t, std::vector<Request>&);
+    bool flushClient(std::size_t);
+};
@@ -7,19 +7,58 @@
 
 #include<fstream>
 #include<sstream>
+#include<stdexcept>
 
 #include "SoS.hpp"
+#include "Parallel.hpp"
+#include "LinkKernel.hpp"
+#include "ExclusionZone.hpp"
 
-void SoS::buildSystems(const std::string& filename) {
-    bool recs_done = false;
+namespace {
 
+// the SoS::summary metrics, primary / secondary receiver with their satellites
+struct SummaryLinks
+{
+    LinkKernel U_link;
+    LinkKernel V_link;
+    const Satellite& P_sat;
+    const Satellite& S_sat;
+
+    SummaryLinks(const Receiver& U, const Receiver& V)
+        : U_link(U), V_link(V), P_sat(U.getInSysSat()), S_sat(V.getInSysSat()) {}
+
+    // same quantities as the calc_data columns of the same name
+    void addSys1(const Satellite& sat, StatsAccumulator& acc) const {
+        acc.add(0, LinkKernel::to_dB(U_link.snr_lin(sat)));
+        acc.add(1, LinkKernel::to_dB(V_link.sinr_lin(S_sat, sat)));
+    }
+    void addSys2(const Satellite& sat, StatsAccumulator& acc) const {
+        acc.add(0, LinkKernel::to_dB(V_link.snr_lin(sat)));
+        acc.add(1, LinkKernel::to_dB(U_link.inr_lin(P_sat, sat)));
+        acc.add(2, LinkKernel::to_dB(U_link.sinr_lin(P_sat, sat)));
+    }
+
+    static StatsSummary summary(const std::vector<DistStats>& sys1, const std::vector<DistStats>& sys2) {
+        StatsSummary s;
+        s.names = {"SNR_sys1_dB", "SINR_sys2_dB", "SNR_sys2_dB", "INR_su_dB", "SINR_sys1_dB"};
+        s.metrics = {sys1[0], sys1[1], sys2[0], sys2[1], sys2[2]};
+        return s;
+    }
+};
+
+}
+
+void SoS::buildSystems(const std::string& filename, bool with_satellites) {
     std::ifstream in(filename);
     if (!in) {
         std::cerr << "Error: could not open " << filename << "\n";
         return;
     }
+    if (with_satellites) {
+        streamed = false;
+    }
 
-    enum Mode { NONE, RECEIVERS, SATELLITES };
+    enum Mode { NONE, SYSTEMS, RECEIVERS, SATELLITES };
     Mode mode = NONE;
     std::string line;
     
@@ -33,15 +72,30 @@ void SoS::buildSystems(const std::string& filename) {
             continue;
         }
         // read line and check contents/format
-        if (line == "Receivers:") {
+        if (line == "Systems:") {
+            mode = SYSTEMS;
+            continue;
+        } else if (line == "Receivers:") {
             mode = RECEIVERS;
             continue;
         } else if (line == "Satellites:") {
             mode = SATELLITES;
             continue;
         }
+        if (mode == SATELLITES && !with_satellites) {
+            continue;
+        }
 
         std::istringstream iss(line);
+        if (mode == SYSTEMS) {
+            SystemParams params;
+            if (!(iss >> params.sys_id >> params.Sp)) {
+                std::cerr << "Warning: bad input line (" << line << ")\n";
+                continue;
+            }
+            setSystemParams(params);
+            continue;
+        }
         if (!((mode == SATELLITES && (iss >> system >> id >> x_ >> y_)) ||
             (mode == RECEIVERS && (iss >> system >> id >> x_ >> y_ >> dim)))) {
             std::cerr << "Warning: bad input line (" << line << ")\n";
@@ -50,31 +104,18 @@ void SoS::buildSystems(const std::string& filename) {
 
         // position
         Vec2 pos = Vec2(x_, y_);
+        System& sys = systems[systemIndex(system)];
 
         switch (mode) {
-            case RECEIVERS:
-                switch (system) {
-                    case 1:
-                        sys1_recs.emplace_back(system, id, pos, dim);
-                        break;
-                    case 2:
-                        sys2_recs.emplace_back(system, id, pos, dim);
-                        break;
-                    default:
-                        std::cerr << "Warning: unknown system " << system << " in line: " << line << "\n";
-                }
+            case RECEIVERS: {
+                RecParams terminal;
+                terminal.N = dim;
+                terminal.channels = channel_plan;
+                sys.recs.push_back(makeReceiver(system, id, pos, recClass(terminal)));
                 break;
+            }
             case SATELLITES:
-                switch (system) {
-                    case 1:
-                        sys1_sats.emplace_back(system, id, pos);
-                        break;
-                    case 2:
-                        sys2_sats.emplace_back(system, id, pos);
-                        break;
-                    default:
-                        std::cerr << "Warning: unknown system " << system << " in line: " << line << "\n";
-                }
+                sys.sats.emplace_back(system, id, pos, sys.sat_class);
                 break;
             default:
                 std::cerr << "Warning: missing section headers\n";
@@ -82,33 +123,198 @@ void SoS::buildSystems(const std::string& filename) {
     }
 }
 
-void SoS::aimSats() {
-    //sys1
-    for (int i = 0; i < sys1_sats.size(); ++i) {
-        sys1_sats[i].aimSat(sys1_recs[0].getRecPos());
+std::size_t SoS::systemSlot(int sys_id) const {
+    // systems stay sorted by sys_id
+    std::size_t k = 0;
+    while (k < systems.size() && systems[k].params.sys_id < sys_id) {
+        ++k;
     }
-    //sys2
-    for (int i = 0; i < sys2_sats.size(); ++i) {
-        sys2_sats[i].aimSat(sys2_recs[0].getRecPos());
+    return k;
+}
+
+std::size_t SoS::systemIndex(int sys_id) {
+    std::size_t k = systemSlot(sys_id);
+    if (k == systems.size() || systems[k].params.sys_id != sys_id) {
+        System sys;
+        sys.params = defaultSystemParams(sys_id);
+        refreshSatClass(sys);
+        systems.insert(systems.begin() + k, std::move(sys));
+    }
+    return k;
+}
+
+void SoS::setSystemParams(const SystemParams& params) {
+    std::size_t k = systemSlot(params.sys_id);
+    if (k == systems.size() || systems[k].params.sys_id != params.sys_id) {
+        System sys;
+        sys.params = params;
+        refreshSatClass(sys);
+        systems.insert(systems.begin() + k, std::move(sys));
+        return;
+    }
+    systems[k].params = params;
+    // satellites read before their parameters were known
+    refreshSatClass(systems[k]);
+}
+
+void SoS::refreshSatClass(System& sys) {
+    SatParams record;
+    record.sys_id = sys.params.sys_id;
+    record.Sp = sys.params.Sp;
+    record.channels = channel_plan;
+    sys.sat_class = ParamTable::sat(record);
+    for (Satellite& sat : sys.sats) {
+        sat.setParams(sys.sat_class);
+    }
+}
+
+RecParamsPtr SoS::recClass(const RecParams& terminal) {
+    for (const RecParamsPtr& record : rec_classes) {
+        if (record->sameInputs(terminal)) {
+            return record;
+        }
+    }
+    rec_classes.push_back(ParamTable::rec(terminal));
+    return rec_classes.back();
+}
+
+Receiver SoS::makeReceiver(int sys_id, int rec_id, Vec2 pos, const RecParamsPtr& param_class) const {
+    Receiver rec;
+    rec.setSysID(sys_id);
+    rec.setRecID(rec_id);
+    rec.setRecPos(pos);
+    rec.setParams(param_class);
+    return rec;
+}
+
+void SoS::requireSatellites(const char* what) const {
+    if (streamed) {
+        throw std::runtime_error{std::string("SoS::") + what
+                                 + ": satellites were streamed by runChunked and are not loaded"};
+    }
+}
+
+void SoS::setChannelPlan(const ChannelPlan& plan) {
+    // every satellite class shares the defaults of SatParams, checked once here
+    if (!plan.fitsBand(SatParams().fc, SatParams().bandwidth)) {
+        throw std::runtime_error{"channel plan outside the satellite band"};
+    }
+    // equal contents keep the current plan and classes
+    if (*channel_plan == plan) {
+        return;
+    }
+    channel_plan = std::make_shared<const ChannelPlan>(plan);
+    // old receiver classes are released once every receiver has moved off them
+    rec_classes.clear();
+    for (System& sys : systems) {
+        refreshSatClass(sys);
+        for (Receiver& rec : sys.recs) {
+            RecParams terminal = rec.params();
+            if (!plan.fitsBand(terminal.fc, terminal.B)) {
+                throw std::runtime_error{"channel plan outside the receiver band"};
+            }
+            terminal.channels = channel_plan;
+            rec.setParams(recClass(terminal));
+        }
+    }
+}
+
+void SoS::generateSystems(const ConstellationConfig& config, unsigned threads) {
+    streamed = false;
+    // create every system before taking references into systems
+    for (const ShellConfig& shell : config.shells) {
+        systemIndex(shell.sys_id);
+    }
+    for (const RecGridConfig& grid : config.rec_grids) {
+        systemIndex(grid.sys_id);
+    }
+
+    // size every system first so the parallel fill only writes into place
+    std::vector<std::size_t> shell_start(config.shells.size());
+    std::vector<std::size_t> grid_start(config.rec_grids.size());
+    std::vector<std::size_t> n_sats(systems.size());
+    std::vector<std::size_t> n_recs(systems.size());
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        n_sats[k] = systems[k].sats.size();
+        n_recs[k] = systems[k].recs.size();
+    }
+    for (std::size_t s = 0; s < config.shells.size(); ++s) {
+        std::size_t k = systemIndex(config.shells[s].sys_id);
+        shell_start[s] = n_sats[k];
+        n_sats[k] += shellSize(config.shells[s]);
+    }
+    for (std::size_t g = 0; g < config.rec_grids.size(); ++g) {
+        std::size_t k = systemIndex(config.rec_grids[g].sys_id);
+        grid_start[g] = n_recs[k];
+        n_recs[k] += std::max(config.rec_grids[g].count, 0);
+    }
+    for (std::size_t k = 0; k < systems.size(); ++k) {
+        systems[k].sats.resize(n_sats[k]);
+        systems[k].recs.resize(n_recs[k]);
+    }
+
+    for (std::size_t s = 0; s < config.shells.size(); ++s) {
+        const ShellConfig& shell = config.shells[s];
+        System& sys = systems[systemIndex(shell.sys_id)];
+        std::size_t start = shell_start[s];
+        parallelFor(shellSize(shell), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                // object IDs are 1-based and contiguous within a system
+                sys.sats[start + k] = Satellite(shell.sys_id, int(start + k + 1), shellPosition(shell, k), sys.sat_class);
+            }
+        }, threads);
+    }
+    for (std::size_t g = 0; g < config.rec_grids.size(); ++g) {
+        const RecGridConfig& grid = config.rec_grids[g];
+        System& sys = systems[systemIndex(grid.sys_id)];
+        std::size_t start = grid_start[g];
+        // one class lookup per grid, the parallel fill only shares the record
+        RecParams terminal;
+        terminal.N = grid.dim;
+        terminal.channels = channel_plan;
+        RecParamsPtr rec_class = recClass(terminal);
+        parallelFor(std::size_t(std::max(grid.count, 0)), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                sys.recs[start + k] = makeReceiver(grid.sys_id, int(start + k + 1), recGridPosition(grid, k), rec_class);
+            }
+        }, threads);
+    }
+}
+
+void SoS::aimSats() {
+    // every system aims at its first receiver
+    for (System& sys : systems) {
+        if (sys.recs.empty()) {
+            continue;
+        }
+        for (int i = 0; i < sys.sats.size(); ++i) {
+            sys.sats[i].aimSat(sys.recs[0].getRecPos());
+        }
     }
 }
 
 void SoS::runSatelliteSelection(int mode) {
-    if (sys1_sats.size() != 0 && sys2_sats.size() != 0 && sys1_recs.size() != 0 && sys2_recs.size() != 0) {
-    } else {
+    requireSatellites("runSatelliteSelection");
+    if (systems.size() < 2) {
         std::cout << "System empty" << std::endl;
         return;
     }
+    for (const System& sys : systems) {
+        if (sys.sats.size() == 0 || sys.recs.size() == 0) {
+            std::cout << "System empty" << std::endl;
+            return;
+        }
+    }
     switch (mode) {
         case 1: {
             // currently set up for only one receiver for each system
-            satSelectBasic(1);
-            sys2_recs[0].setOutSysSat(sys1_recs[0].getInSysSat());
-            std::cout << "Sys1 chose Satellite: \n" << sys1_recs[0].getInSysSat().toString() << std::endl;
+            satSelectBasic(0);
+            secondary().recs[0].setOutSysSat(primary().recs[0].getInSysSat());
+            std::cout << "Sys" << primary().params.sys_id << " chose Satellite: \n" << primary().recs[0].getInSysSat().toString() << std::endl;
             
-            satSelectBasic(2);
-            sys1_recs[0].setOutSysSat(sys2_recs[0].getInSysSat());
-            std::cout << "Sys2 chose Satellite: \n" << sys2_recs[0].getInSysSat().toString() << std::endl;
+            satSelectBasic(1);
+            primary().recs[0].setOutSysSat(secondary().recs[0].getInSysSat());
+            std::cout << "Sys" << secondary().params.sys_id << " chose Satellite: \n" << secondary().recs[0].getInSysSat().toString() << std::endl;
             break;
         }
         case 2: {
@@ -121,70 +327,64 @@ void SoS::runSatelliteSelection(int mode) {
         }
         default:
             std::cerr << "Warning: unknown selection mode\n";
+            return;
+    }
+    // systems beyond the first two have no coordination, each maximizes SNR
+    for (std::size_t k = 2; k < systems.size(); ++k) {
+        satSelectBasic(k);
+        std::cout << "Sys" << systems[k].params.sys_id << " chose Satellite: \n" << systems[k].recs[0].getInSysSat().toString() << std::endl;
     }
 }
 
-Satellite& SoS::satSelectBasic(int sys) {
-    int best_index = -1;
-    double max_snr = -1;
-    double theta;
+Satellite& SoS::satSelectBasic(std::size_t k) {
+    if (k >= systems.size()) {
+        throw std::runtime_error{"unknown system in satSelectBasic"};
+    }
+    std::vector<Satellite>& sats = systems[k].sats;
+    Receiver& rec = systems[k].recs[0];
+    CandidateList& ranked = rec.getCandidates();
+    LinkKernel link(rec);
+    const double min_snr = g_min_select_lin;
+    double snr;
     double Pt;
 
-    // primary system
-    if (sys == 1) { 
-        std::vector<double> SNR(sys1_sats.size());
-        for (int i = 0; i < sys1_sats.size(); ++i) {
-            SNR[i] = sys1_recs[0].calc_SNR(sys1_sats[i]);
-            theta = std::abs(sys1_recs[0].getElevationAngle(sys1_sats[i].getSatPos()));
-            Pt = sys1_sats[i].getPt_dBm();
-            if (SNR[i] > max_snr && theta >= g_min_el_angle && Pt >= sys1_recs[0].getPr_req_dBm()) {
-                max_snr = SNR[i];
-                best_index = i;
-            }
-        }
-        if (best_index == -1 && max_snr == -1) {
-            std::cerr << "Error: no satellite selected\n";
+    // best SNR and runners-up in one pass, ranked on linear SNR
+    ranked.reset(top_k);
+    for (int i = 0; i < sats.size(); ++i) {
+        snr = link.snr_lin(sats[i]);
+        Pt = sats[i].getPt_dBm();
+        if (snr > min_snr && link.visible(sats[i]) && Pt >= rec.getPr_req_dBm()) {
+            ranked.offer(i, snr);
         }
-        sys1_recs[0].pairSat(sys1_sats[best_index]);
-        return sys1_sats[best_index];
     }
-
-    // secondary system
-    if (sys == 2) {
-        std::vector<double> SNR(sys2_sats.size());
-        for (int i = 0; i < sys2_sats.size(); ++i) {
-            SNR[i] = sys2_recs[0].calc_SNR(sys2_sats[i]);
-            theta = std::abs(sys2_recs[0].getElevationAngle(sys2_sats[i].getSatPos()));
-            Pt = sys2_sats[i].getPt_dBm();
-            if (SNR[i] > max_snr && theta >= g_min_el_angle && Pt >= sys2_recs[0].getPr_req_dBm()) {
-                max_snr = SNR[i];
-                best_index = i;
-            }
-        }
-        if (best_index == -1 && max_snr == -1) {
-            std::cerr << "Error: no satellite selected\n";
-        }
-        sys2_recs[0].pairSat(sys2_sats[best_index]);
-        return sys2_sats[best_index];
+    ranked.finalize(true);
+    int best_index = ranked.best();
+    if (best_index < 0) {
+        throw std::runtime_error{"satSelectBasic: no valid satellite found"};
     }
-    throw std::runtime_error{"unknown system in satSelectBasic"};
+    rec.pairSat(sats[best_index]);
+    return sats[best_index];
 }
 
 Satellite& SoS::satSelectProtected() {
+    std::vector<Receiver>& sys1_recs = primary().recs;
+    std::vector<Satellite>& sys2_sats = secondary().sats;
+    std::vector<Receiver>& sys2_recs = secondary().recs;
     // primary system selection does not change -> best SNR
-    Satellite sat1 = satSelectBasic(1);
+    Satellite sat1 = satSelectBasic(0);
     sys2_recs[0].setOutSysSat(sys1_recs[0].getInSysSat());
     // secondary system selection
-    int best_index = -1;
-    double max_snr = -1;
-    double theta;
+    CandidateList& ranked = sys2_recs[0].getCandidates();
+    LinkKernel V_link(sys2_recs[0]);
+    // most candidates are screened geometrically, exact INR only near the zone boundary
+    ExclusionZone zone(sys1_recs[0], sys1_recs[0].getInSysSat(), INR_max);
+    const double min_snr = g_min_select_lin;
+    double snr;
     double Pt;
-    std::vector<double> INR(sys2_sats.size());
     std::vector<int> S; // vector of indexes of secondary satellites that pass interference threshold
 
     for (int i = 0; i < sys2_sats.size(); ++i) {
-        INR[i] = sys1_recs[0].calc_INR(sys1_recs[0].getInSysSat(), sys2_sats[i]);
-        if (INR[i] < INR_max) {
+        if (zone.passes(sys2_sats[i])) {
             S.emplace_back(i);
         }
     }
@@ -192,16 +392,16 @@ Satellite& SoS::satSelectProtected() {
         std::cerr << "Error: no sys2 sats meet INR threshold" << std::endl;
     }
 
-    std::vector<double> SNR(S.size());
+    ranked.reset(top_k);
     for (int i = 0; i < S.size(); ++i) {
-        SNR[i] = sys2_recs[0].calc_SNR(sys2_sats[S[i]]);
-        theta = std::abs(sys2_recs[0].getElevationAngle(sys2_sats[S[i]].getSatPos()));
+        snr = V_link.snr_lin(sys2_sats[S[i]]);
         Pt = sys2_sats[S[i]].getPt_dBm();
-        if (SNR[i] > max_snr && theta >= g_min_el_angle && Pt >= sys2_recs[0].getPr_req_dBm()) {
-            max_snr = SNR[i];
-            best_index = S[i];
+        if (snr > min_snr && V_link.visible(sys2_sats[S[i]]) && Pt >= sys2_recs[0].getPr_req_dBm()) {
+            ranked.offer(S[i], snr);
         }
     }
+    ranked.finalize(true);
+    int best_index = ranked.best();
     if (best_index < 0) {
         throw std::runtime_error{"satSelectBasic: no valid satellite found"};
     }
@@ -213,25 +413,29 @@ Satellite& SoS::satSelectProtected() {
 }
 
 Satellite& SoS::satSelectBestSys2() {
+    std::vector<Receiver>& sys1_recs = primary().recs;
+    std::vector<Satellite>& sys2_sats = secondary().sats;
+    std::vector<Receiver>& sys2_recs = secondary().recs;
     // primary system selection does not change -> best SNR
-    Satellite sat1 = satSelectBasic(1);
+    Satellite sat1 = satSelectBasic(0);
     sys2_recs[0].setOutSysSat(sys1_recs[0].getInSysSat());
     
     // secondary system selection -> maximize SINR
-    int best_index = -1;
-    double max_sinr = -1;
-    double epsilon;
+    CandidateList& ranked = sys2_recs[0].getCandidates();
+    LinkKernel V_link(sys2_recs[0]);
+    const double min_sinr = g_min_select_lin;
+    double sinr;
     double Pt;
-    std::vector<double> SINR(sys2_sats.size());
+    ranked.reset(top_k);
     for (int i = 0; i < sys2_sats.size(); ++i) {
-        SINR[i] = sys2_recs[0].calc_SINR(sys2_sats[i], sat1);
-        epsilon = std::abs(sys2_recs[0].getElevationAngle(sys2_sats[i].getSatPos()));
+        sinr = V_link.sinr_lin(sys2_sats[i], sat1);
         Pt = sys2_sats[i].getPt_dBm();
-        if (SINR[i] > max_sinr && epsilon >= g_min_el_angle && Pt >= sys2_recs[0].getPr_req_dBm()) {
-            max_sinr = SINR[i];
-            best_index = i;
+        if (sinr > min_sinr && V_link.visible(sys2_sats[i]) && Pt >= sys2_recs[0].getPr_req_dBm()) {
+            ranked.offer(i, sinr);
         }
     }
+    ranked.finalize(true);
+    int best_index = ranked.best();
     if (best_index < 0) {
         throw std::runtime_error{"satSelectBasic: no valid satellite found"};
     }
@@ -242,7 +446,32 @@ Satellite& SoS::satSelectBestSys2() {
     return sys2_recs[0].getInSysSat();
 }
 
+Satellite* SoS::satSelectFallback(std::size_t k, const std::function<bool(const Satellite&)>& usable) {
+    // lists from runChunked point into satellites that are not resident
+    requireSatellites("satSelectFallback");
+    if (k >= systems.size() || systems[k].recs.empty()) {
+        return nullptr;
+    }
+    std::vector<Satellite>& sats = systems[k].sats;
+    Receiver& rec = systems[k].recs[0];
+    const CandidateList& ranked = rec.getCandidates();
+    for (std::size_t c = 0; c < ranked.size(); ++c) {
+        Satellite& sat = sats[ranked[c].index];
+        if (usable(sat)) {
+            rec.pairSat(sat);
+            // the peer's interference terms follow the new satellite
+            if (k < 2 && systems.size() > 1 && !systems[1 - k].recs.empty()) {
+                systems[1 - k].recs[0].setOutSysSat(rec.getInSysSat());
+            }
+            return &rec.getInSysSat();
+        }
+    }
+    return nullptr;
+}
+
 std::string SoS::analyze() {
+    std::vector<Receiver>& sys1_recs = primary().recs;
+    std::vector<Receiver>& sys2_recs = secondary().recs;
     Satellite sys1_pair = sys1_recs[0].getInSysSat();
     Satellite sys2_pair = sys2_recs[0].getInSysSat();
     std::ostringstream oss;
@@ -274,56 +503,89 @@ std::string SoS::analyze() {
     return oss.str();
 }
 
+DataReport SoS::report(const std::vector<Column>& columns) {
+    requireSatellites("report");
+    return DataReport(primary().sats, secondary().sats, primary().recs[0], secondary().recs[0], columns);
+}
+
+AgentStats SoS::runAgents(const AgentConfig& config) {
+    requireSatellites("runAgents");
+    AgentModel model(systems, INR_max, config);
+    return model.run();
+}
+
+ChunkRunStats SoS::runChunked(const std::string& filename, int mode, const ChunkConfig& config) {
+    buildSystems(filename, false);
+    streamed = true;
+    ChunkedRunner runner(systems, INR_max, top_k, config);
+    return runner.run(filename, mode);
+}
+
+CoverageMap SoS::coverageMap(const CoverageGrid& grid, unsigned threads) {
+    requireSatellites("coverageMap");
+    const Satellite* interferer = nullptr;
+    if (systems.size() > 1 && !secondary().recs.empty() && secondary().recs[0].isPaired()) {
+        interferer = &secondary().recs[0].getInSysSat();
+    }
+    return computeCoverage(primary().sats, interferer, grid, threads);
+}
+
 void SoS::calc_data_out(const std::string& filename) {
+    calc_data_out(filename, DataReport::allColumns());
+}
+
+void SoS::calc_data_out(const std::string& filename, const std::vector<Column>& columns) {
     std::ofstream out(filename);
     if (!out) {
         std::cerr << "Could not open " << filename << " for writing\n";
         return;
     }
 
-    Receiver U_rec = sys1_recs[0];
-    Satellite P_sat = U_rec.getInSysSat();
-    Receiver V_rec = sys2_recs[0];
-    Satellite S_sat = V_rec.getInSysSat();
-    int n1 = sys1_sats.size();
-    int n2 = sys2_sats.size();
-    int n = std::max(n1, n2);
-
-    for (int i = 0; i < n; ++i) {
-        out << i;
-        if (i < n1) {
-            double sys1_range = sys1_sats[i].getSatPos().x; 
-            double snr1_dB = U_rec.calc_SNR(sys1_sats[i]);
-            double inr_dB_pv = V_rec.calc_INR(S_sat, P_sat);
-            double sinr2_dB = V_rec.calc_SINR(S_sat, sys1_sats[i]);
-            out << ',' << sys1_range << ',' << snr1_dB << ',' << inr_dB_pv << ',' << sinr2_dB;
-        } else {
-            out << ",,,,";
+    DataReport table = report(columns);
+    table.write(out);
+    out.close();
+}
+
+void SoS::calc_data_out(const std::string& filename, StatsSummary& summary) {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return;
+    }
+
+    DataReport table = report(DataReport::allColumns());
+    const std::vector<Satellite>& sys1_sats = primary().sats;
+    const std::vector<Satellite>& sys2_sats = secondary().sats;
+    SummaryLinks links(primary().recs[0], secondary().recs[0]);
+    // row by row on this thread, the streams keep the block order of summary()
+    StatsStream stream1(2, 1);
+    StatsStream stream2(3, 1);
+    ReportRow row;
+    while (table.next(row)) {
+        table.writeRow(out, row);
+        std::size_t i = row.index;
+        if (i < sys1_sats.size()) {
+            stream1.add(1, [&](std::size_t, StatsAccumulator& acc) { links.addSys1(sys1_sats[i], acc); });
         }
-        if (i < n2) {
-            double sys2_range = sys2_sats[i].getSatPos().x;
-            double inr_dB_su = U_rec.calc_INR(P_sat, sys2_sats[i]);
-            double snr2_dB = V_rec.calc_SNR(sys2_sats[i]);
-            double sinr1_dB = U_rec.calc_SINR(P_sat, sys2_sats[i]);
-            double angle = U_rec.calc_rec_int_angle(P_sat, sys2_sats[i]) * 180 / g_PI;
-            out << ',' << sys2_range << ',' << snr2_dB << ',' << inr_dB_su << ',' << sinr1_dB << ',' << angle;
-        } else {
-            out << ",,,,,";
+        if (i < sys2_sats.size()) {
+            stream2.add(1, [&](std::size_t, StatsAccumulator& acc) { links.addSys2(sys2_sats[i], acc); });
         }
-        out << '\n';
     }
     out.close();
+    summary = SummaryLinks::summary(stream1.finish(), stream2.finish());
 }
 
 void SoS::feasibleCount_out(const std::string& filename) {
+    requireSatellites("feasibleCount_out");
     std::ofstream out(filename);
     if (!out) {
         std::cerr << "Could not open " << filename << " for writing\n";
         return;
     }
 
-    Receiver U_rec = sys1_recs[0];
+    Receiver U_rec = primary().recs[0];
     Satellite P_sat = U_rec.getInSysSat();
+    std::vector<Satellite>& sys2_sats = secondary().sats;
 
     for (double INR_th = -2; INR_th >= -18; INR_th -= 1) {
         double count = 0;
@@ -337,4 +599,121 @@ void SoS::feasibleCount_out(const std::string& filename) {
         out << INR_th << ',' << count << ',' << percent << '\n';
     }
     out.close();
-}
\ No newline at end of file
+}
+
+StatsSummary SoS::summary(unsigned threads) {
+    requireSatellites("summary");
+    const std::vector<Satellite>& sys1_sats = primary().sats;
+    const std::vector<Satellite>& sys2_sats = secondary().sats;
+    SummaryLinks links(primary().recs[0], secondary().recs[0]);
+    std::vector<DistStats> sys1 = accumulateStats(sys1_sats.size(), 2, [&](std::size_t i, StatsAccumulator& acc) {
+        links.addSys1(sys1_sats[i], acc);
+    }, threads);
+    std::vector<DistStats> sys2 = accumulateStats(sys2_sats.size(), 3, [&](std::size_t i, StatsAccumulator& acc) {
+        links.addSys2(sys2_sats[i], acc);
+    }, threads);
+    return SummaryLinks::summary(sys1, sys2);
+}
+
+void SoS::summary_out(const std::string& filename, unsigned threads) {
+    summary(threads).write(filename);
+}
+
+InterferenceMatrix SoS::interferenceMatrix(unsigned threads) {
+    InterferenceMatrix m;
+    std::vector<Receiver*> recs;        // rows
+    std::vector<const Satellite*> sats; // columns, active satellite of each paired receiver
+    for (System& sys : systems) {
+        for (Receiver& rec : sys.recs) {
+            if (!rec.isPaired()) {
+                continue;
+            }
+            recs.push_back(&rec);
+            sats.push_back(&rec.getInSysSat());
+            m.row_sys.push_back(rec.getSysID());
+            m.row_rec.push_back(rec.getRecID());
+            m.col_sys.push_back(rec.getInSysSat().getSysID());
+            m.col_sat.push_back(rec.getInSysSat().getSatID());
+        }
+    }
+    m.rows = recs.size();
+    m.cols = sats.size();
+    m.inr_dB.assign(m.rows * m.cols, -INF);
+
+    // tiles of tile x tile entries keep a block of receivers and satellites in cache
+    const std::size_t tile = 64;
+    std::size_t row_tiles = (m.rows + tile - 1) / tile;
+    std::size_t col_tiles = (m.cols + tile - 1) / tile;
+    parallelFor(row_tiles * col_tiles, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t) {
+            std::size_t r0 = (t / col_tiles) * tile;
+            std::size_t c0 = (t % col_tiles) * tile;
+            std::size_t r1 = std::min(m.rows, r0 + tile);
+            std::size_t c1 = std::min(m.cols, c0 + tile);
+            for (std::size_t r = r0; r < r1; ++r) {
+                Receiver& rec = *recs[r];
+                const Satellite& own = *sats[r];
+                for (std::size_t c = c0; c < c1; ++c) {
+                    if (m.col_sys[c] == m.row_sys[r]) {
+                        continue;
+                    }
+                    m.inr_dB[r * m.cols + c] = rec.calc_INR(own, *sats[c]);
+                }
+            }
+        }
+    }, threads);
+    return m;
+}
+
+void SoS::interference_out(const std::string& filename, unsigned threads) {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return;
+    }
+
+    InterferenceMatrix m = interferenceMatrix(threads);
+    // header row: sys:sat of each active satellite
+    out << "rec";
+    for (std::size_t c = 0; c < m.cols; ++c) {
+        out << ',' << m.col_sys[c] << ':' << m.col_sat[c];
+    }
+    out << '\n';
+    for (std::size_t r = 0; r < m.rows; ++r) {
+        out << m.row_sys[r] << ':' << m.row_rec[r];
+        for (std::size_t c = 0; c < m.cols; ++c) {
+            out << ',';
+            if (m.col_sys[c] != m.row_sys[r]) {
+                out << m.at(r, c);
+            }
+        }
+        out << '\n';
+    }
+    out.close();
+}
+
+void SoS::channel_data_out(const std::string& filename) {
+    requireSatellites("channel_data_out");
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return;
+    }
+
+    Receiver U_rec = primary().recs[0];
+    Satellite P_sat = U_rec.getInSysSat();
+    const std::vector<Satellite>& sys2_sats = secondary().sats;
+    const ChannelPlan& plan = U_rec.getChannelPlan();
+    std::vector<double> snr, inr, sinr;
+
+    // the wanted link is the same on every row, one interference pass per satellite, one row per channel
+    U_rec.calc_SNR_channels(P_sat, snr);
+    for (std::size_t i = 0; i < sys2_sats.size(); ++i) {
+        U_rec.calc_INR_channels(P_sat, sys2_sats[i], inr);
+        Receiver::calc_SINR_channels(snr, inr, sinr);
+        for (std::size_t k = 0; k < plan.size(); ++k) {
+            out << i << ',' << k << ',' << plan[k].fc << ',' << snr[k] << ',' << inr[k] << ',' << sinr[k] << '\n';
+        }
+    }
+    out.close();
+}
@@ -7,49 +7,146 @@
 
 #pragma once
 
+#include<functional>
 #include<string>
 
 #include "Receiver.hpp"
+#include "System.hpp"
+#include "Constellation.hpp"
+#include "Report.hpp"
+#include "Agents.hpp"
+#include "CoverageMap.hpp"
+#include "Stats.hpp"
+#include "Chunked.hpp"
 
 class SoS {
 public:
     SoS() {}
 
-    void buildSystems(const std::string&);
+    // with_satellites = false reads only systems and receivers (ChunkedRunner streams the satellites)
+    void buildSystems(const std::string&, bool with_satellites = true);
+    void generateSystems(const ConstellationConfig&, unsigned threads = 0);
+    void setSystemParams(const SystemParams&);
+    // shared by every satellite and receiver, set before satellite selection
+    void setChannelPlan(const ChannelPlan&);
 
     // read-only accessors
+    // systems are ordered by sys_id, the two lowest IDs are primary and secondary
+    const std::vector<System>& systemList() const noexcept {
+        return systems;
+    }
     const std::vector<Satellite>& constellationSys1() const noexcept {
-        return sys1_sats;
+        return systems.size() > 0 ? systems[0].sats : empty_sats;
     }
     const std::vector<Satellite>& constellationSys2() const noexcept {
-        return sys2_sats;
+        return systems.size() > 1 ? systems[1].sats : empty_sats;
     }
     const std::vector<Receiver>& receiversSys1() const noexcept {
-        return sys1_recs;
+        return systems.size() > 0 ? systems[0].recs : empty_recs;
     }
     const std::vector<Receiver>& receiversSys2() const noexcept {
-        return sys2_recs;
+        return systems.size() > 1 ? systems[1].recs : empty_recs;
     }
 
     void aimSats();
     void runSatelliteSelection(int);
+    // length of the ranked candidate list kept per receiver by each selection pass, at least 1
+    void setCandidateCount(std::size_t k) { top_k = std::max<std::size_t>(k, 1); }
+
+    /*
+    * fallback selection
+    * pairs receiver 0 of systems[k] with the best candidate from its last
+    * selection pass that is still usable (not lost, within INR limits, has capacity)
+    * for the primary / secondary pair the other receiver's out-of-system satellite follows
+    * O(k) in the candidate count, nullptr once the list is exhausted -> rerun selection
+    * */
+    Satellite* satSelectFallback(std::size_t, const std::function<bool(const Satellite&)>&);
     std::string analyze();
+    DataReport report(const std::vector<Column>&);
     void calc_data_out(const std::string&);
+    void calc_data_out(const std::string&, const std::vector<Column>&);
+    // full table, summary (as below) filled in the same loop over the rows
+    void calc_data_out(const std::string&, StatsSummary&);
     void feasibleCount_out(const std::string&);
 
+    /*
+    * distribution summary of the calc_data columns without the table
+    * SNR / SINR over primary satellites, SNR / INR / SINR over secondary satellites,
+    * accumulated in the compute loop, identical for any thread count
+    * and to the one filled by calc_data_out
+    * */
+    StatsSummary summary(unsigned threads = 0);
+    void summary_out(const std::string&, unsigned threads = 0);
+    void channel_data_out(const std::string&);
+
+    /*
+    * agent-based run
+    * every satellite and receiver is a coroutine agent woken only by its own
+    * events (satellite lost, interference reported, recheck timer)
+    * final pairings are written back to the receivers
+    * */
+    AgentStats runAgents(const AgentConfig&);
+
+    /*
+    * out-of-core selection
+    * systems and receivers are loaded from the file, satellites are streamed
+    * from it block by block and never held in full; receivers end up paired
+    * and ranked as after runSatelliteSelection(mode), the summary is filled on
+    * the way, satellite lists stay empty
+    * until satellites are loaded again (buildSystems / generateSystems) every
+    * call that walks them (selection, fallback, reports, summary, coverage,
+    * agents) throws std::runtime_error, analyze and the interference matrix
+    * only need the pairings and still work
+    * */
+    ChunkRunStats runChunked(const std::string&, int, const ChunkConfig& = ChunkConfig());
+
+    /*
+    * coverage map
+    * primary system service over a grid of hypothetical terminals, interfered by
+    * the satellite the secondary system is currently using (if paired)
+    * */
+    CoverageMap coverageMap(const CoverageGrid&, unsigned threads = 0);
+
+    /*
+    * inter-system interference
+    * every paired receiver against the active satellite of every other system
+    * computed in cache-sized tiles spread across threads
+    * */
+    InterferenceMatrix interferenceMatrix(unsigned threads = 0);
+    void interference_out(const std::string&, unsigned threads = 0);
+
 private:
-    std::vector<Satellite> sys1_sats;
-    std::vector<Receiver> sys1_recs;
-    std::vector<Satellite> sys2_sats;
-    std::vector<Receiver> sys2_recs;
+    std::vector<System> systems;
     double SNR_min = 25; // minimum threshold for signal to noise ratio dB
     double INR_max = -12.2; // threshold for prohibitive interference
+    std::size_t top_k = 8;
+    std::shared_ptr<const ChannelPlan> channel_plan = ChannelPlan::defaultPlan();
+    std::vector<RecParamsPtr> rec_classes; // receiver classes used by this SoS, looked up before ParamTable
+    bool streamed = false; // satellites were streamed by runChunked and are not resident
+
+    inline static const std::vector<Satellite> empty_sats{};
+    inline static const std::vector<Receiver> empty_recs{};
+
+    // position of sys_id in systems, or where it would be inserted
+    std::size_t systemSlot(int) const;
+    // index of sys_id in systems, created with default parameters if missing
+    std::size_t systemIndex(int);
+    // intern the shared satellite record of a system and point its satellites at it
+    void refreshSatClass(System&);
+    // receiver class for a terminal, looked up among the classes this SoS holds first
+    RecParamsPtr recClass(const RecParams&);
+    Receiver makeReceiver(int, int, Vec2, const RecParamsPtr&) const;
+    // throws when the satellite lists were streamed, argument names the caller
+    void requireSatellites(const char*) const;
+    System& primary() { return systems[0]; }
+    System& secondary() { return systems[1]; }
 
     /*
     * satellite selection
     * both systems maximize SNR, no knowledge sharing
+    * argument is the index into systems
     * */
-    Satellite& satSelectBasic(int);
+    Satellite& satSelectBasic(std::size_t);
 
     /*
     * protected satellite selection
@@ -65,4 +162,4 @@ private:
     * secondary system takes best SINR knowing which primary system satellite is in use
     * */
     Satellite&  satSelectBestSys2();
-};
\ No newline at end of file
+};
@@ -0,0 +1,173 @@
+/*
+ * File: Stats.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: streaming, mergeable statistics for SNR / INR / SINR in dB
+ * */
+
+#include<fstream>
+#include<iostream>
+#include<stdexcept>
+
+#include "Stats.hpp"
+
+void Moments::add(double x) {
+    n++;
+    double delta = x - mean;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+    min = std::min(min, x);
+    max = std::max(max, x);
+}
+
+void Moments::merge(const Moments& o) {
+    if (o.n == 0) {
+        return;
+    }
+    if (n == 0) {
+        *this = o;
+        return;
+    }
+    double total = double(n + o.n);
+    double delta = o.mean - mean;
+    mean += delta * double(o.n) / total;
+    m2 += o.m2 + delta * delta * double(n) * double(o.n) / total;
+    n += o.n;
+    min = std::min(min, o.min);
+    max = std::max(max, o.max);
+}
+
+double Moments::variance() const {
+    return n > 1 ? m2 / double(n - 1) : 0.0;
+}
+
+Histogram::Histogram(double lo_, double hi_, double width_)
+    : lo(lo_), width(width_), counts(std::size_t(std::ceil((hi_ - lo_) / width_)), 0) {}
+
+void Histogram::add(double x) {
+    double pos = (x - lo) / width;
+    if (pos < 0) {
+        under++;
+    } else if (pos >= double(counts.size())) {
+        over++;
+    } else {
+        counts[std::size_t(pos)]++;
+    }
+}
+
+void Histogram::merge(const Histogram& o) {
+    if (o.lo != lo || o.width != width || o.counts.size() != counts.size()) {
+        throw std::runtime_error{"histogram layouts do not match"};
+    }
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += o.counts[i];
+    }
+    under += o.under;
+    over += o.over;
+}
+
+std::uint64_t Histogram::count() const {
+    std::uint64_t total = under + over;
+    for (std::uint64_t c : counts) {
+        total += c;
+    }
+    return total;
+}
+
+double Histogram::quantile(double q) const {
+    std::uint64_t total = count();
+    if (total == 0) {
+        return NAN;
+    }
+    double target = std::clamp(q, 0.0, 1.0) * double(total);
+    double seen = double(under);
+    if (target <= seen && under > 0) {
+        return lo;
+    }
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        if (seen + double(counts[i]) >= target) {
+            double frac = (target - seen) / double(counts[i]);
+            return lo + (double(i) + frac) * width;
+        }
+        seen += double(counts[i]);
+    }
+    return lo + double(counts.size()) * width;
+}
+
+void DistStats::add(double x) {
+    if (!std::isfinite(x)) {
+        nonfinite++;
+        return;
+    }
+    moments.add(x);
+    hist.add(x);
+}
+
+void DistStats::merge(const DistStats& o) {
+    moments.merge(o.moments);
+    hist.merge(o.hist);
+    nonfinite += o.nonfinite;
+}
+
+std::vector<DistStats> StatsStream::finish() const {
+    std::vector<DistStats> out(metrics);
+    for (std::size_t m = 0; m < metrics; ++m) {
+        out[m].moments = merged[m];
+        out[m].moments.merge(open[m]);
+    }
+    for (const std::vector<DistStats>& thread_stats : per_thread) {
+        for (std::size_t m = 0; m < metrics; ++m) {
+            out[m].hist.merge(thread_stats[m].hist);
+            out[m].nonfinite += thread_stats[m].nonfinite;
+        }
+    }
+    return out;
+}
+
+bool StatsSummary::write(const std::string& filename) const {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Could not open " << filename << " for writing\n";
+        return false;
+    }
+    out << "#metric, count, nonfinite, mean, std, min, max, p01, p05, p50, p95, p99\n";
+    for (std::size_t m = 0; m < metrics.size(); ++m) {
+        const DistStats& d = metrics[m];
+        out << names[m] << ',' << d.moments.n << ',' << d.nonfinite << ','
+            << d.moments.mean << ',' << std::sqrt(d.moments.variance()) << ',';
+        if (d.moments.n > 0) {
+            out << d.moments.min << ',' << d.moments.max;
+        } else {
+            out << ',';
+        }
+        for (double q : {0.01, 0.05, 0.5, 0.95, 0.99}) {
+            out << ',' << d.hist.quantile(q);
+        }
+        out << '\n';
+    }
+
+    out << "#metric, bin_lo_dB, count\n";
+    for (std::size_t m = 0; m < metrics.size(); ++m) {
+        const Histogram& h = metrics[m].hist;
+        // fine bins folded into 1 dB bins, exact as long as 1 dB is a multiple of the width
+        std::size_t per_dB = std::max<std::size_t>(1, std::size_t(std::llround(1.0 / h.binWidth())));
+        if (h.underflow() > 0) {
+            out << names[m] << ",under," << h.underflow() << '\n';
+        }
+        for (std::size_t i = 0; i < h.bins(); i += per_dB) {
+            std::uint64_t c = 0;
+            for (std::size_t j = i; j < std::min(h.bins(), i + per_dB); ++j) {
+                c += h.binCount(j);
+            }
+            if (c > 0) {
+                out << names[m] << ',' << h.lower() + double(i) * h.binWidth() << ',' << c << '\n';
+            }
+        }
+        if (h.overflow() > 0) {
+            out << names[m] << ",over," << h.overflow() << '\n';
+        }
+    }
+    return bool(out);
+}
@@ -0,0 +1,193 @@
+/*
+ * File: Stats.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: streaming, mergeable statistics for SNR / INR / SINR in dB
+ * */
+
+#pragma once
+#include<algorithm>
+#include<cmath>
+#include<cstdint>
+#include<string>
+#include<vector>
+
+#include "MyUtil.hpp"
+#include "Parallel.hpp"
+
+// mean / variance / extrema, Welford updates and Chan et al. merges
+struct Moments
+{
+    std::uint64_t n = 0;
+    double mean = 0;
+    double m2 = 0; // sum of squared deviations from the mean
+    double min = INF;
+    double max = -INF;
+
+    void add(double);
+    void merge(const Moments&);
+    double variance() const; // sample variance, 0 below two values
+};
+
+/*
+ * fixed-width bins over [lo, hi) plus under / overflow counts
+ * counts are integers so merging is exact and order independent, with fine
+ * bins this doubles as the quantile sketch (error <= one bin width)
+ * */
+class Histogram {
+    public:
+    Histogram(double lo, double hi, double width);
+
+    void add(double);
+    // layouts must match
+    void merge(const Histogram&);
+
+    std::uint64_t count() const;
+    // linear within the bin holding the q-th value, lo / hi for under / overflow
+    double quantile(double) const;
+
+    double lower() const { return lo; }
+    double binWidth() const { return width; }
+    std::size_t bins() const { return counts.size(); }
+    std::uint64_t binCount(std::size_t i) const { return counts[i]; }
+    std::uint64_t underflow() const { return under; }
+    std::uint64_t overflow() const { return over; }
+
+    private:
+    double lo;
+    double width;
+    std::vector<std::uint64_t> counts;
+    std::uint64_t under = 0;
+    std::uint64_t over = 0;
+};
+
+// default layout for link budget values, 0.05 dB bins over [-250, 150) dB
+const double g_stats_lo_dB = -250;
+const double g_stats_hi_dB = 150;
+const double g_stats_bin_dB = 0.05;
+
+// one dB-valued quantity, non-finite values (no interferer, nulls) are only counted
+struct DistStats
+{
+    Moments moments;
+    Histogram hist{g_stats_lo_dB, g_stats_hi_dB, g_stats_bin_dB};
+    std::uint64_t nonfinite = 0;
+
+    void add(double);
+    void merge(const DistStats&);
+};
+
+// named metrics written together as one summary file
+struct StatsSummary
+{
+    std::vector<std::string> names;
+    std::vector<DistStats> metrics;
+
+    /*
+    * text summary:
+    * #metric, count, nonfinite, mean, std, min, max, p01, p05, p50, p95, p99
+    * then the non-empty 1 dB bins of every metric:
+    * #metric, bin_lo_dB, count
+    * */
+    bool write(const std::string&) const;
+};
+
+/*
+ * statistics over a stream of batches, body(i, acc) calls acc.add(metric, value_dB)
+ * for item i of the batch
+ *
+ * items are numbered across batches and cut into fixed blocks independent of the
+ * batch sizes and the thread count, moments are kept per block and merged in
+ * block order (a block left open by one batch is continued by the next),
+ * histograms per thread (exact), allocated once per stream and merged once in
+ * finish(), so the result is bit-identical for any batching and thread count
+ * */
+const std::size_t g_stats_block = 4096;
+
+class StatsAccumulator {
+    public:
+    StatsAccumulator(std::vector<DistStats>& h, Moments* m) : thread_stats(h), block_moments(m) {}
+
+    void add(std::size_t metric, double value) {
+        if (!std::isfinite(value)) {
+            thread_stats[metric].nonfinite++;
+            return;
+        }
+        thread_stats[metric].hist.add(value);
+        block_moments[metric].add(value);
+    }
+
+    private:
+    std::vector<DistStats>& thread_stats; // moments unused, histograms and nonfinite only
+    Moments* block_moments;               // one per metric
+};
+
+class StatsStream {
+    public:
+    explicit StatsStream(std::size_t metrics_, unsigned threads = 0)
+        : metrics(metrics_), workers(workerCount(threads)), merged(metrics_), open(metrics_) {}
+
+    template<typename Body>
+    void add(std::size_t n, const Body& body);
+
+    // one entry per metric, the open block included
+    std::vector<DistStats> finish() const;
+
+    private:
+    std::size_t metrics;
+    std::size_t workers;
+    std::size_t items = 0;                         // seen by earlier batches
+    std::vector<std::vector<DistStats>> per_thread; // grows to the widest batch, never shrinks
+    std::vector<Moments> block_moments;            // blocks of the current batch, reused
+    std::vector<Moments> merged;                   // closed blocks, in block order
+    std::vector<Moments> open;                     // block holding the next item
+};
+
+template<typename Body>
+void StatsStream::add(std::size_t n, const Body& body) {
+    if (n == 0) {
+        return;
+    }
+    std::size_t first = items / g_stats_block;
+    std::size_t blocks = (items + n - 1) / g_stats_block - first + 1;
+    block_moments.assign(blocks * metrics, Moments());
+    std::copy(open.begin(), open.end(), block_moments.begin());
+    std::size_t t = std::min(workers, blocks);
+    if (per_thread.size() < t) {
+        per_thread.resize(t, std::vector<DistStats>(metrics));
+    }
+
+    std::size_t base = items;
+    std::size_t chunk = (blocks + t - 1) / t;
+    parallelFor(t, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            for (std::size_t b = k * chunk; b < std::min(blocks, (k + 1) * chunk); ++b) {
+                StatsAccumulator acc(per_thread[k], &block_moments[b * metrics]);
+                std::size_t i_begin = std::max(base, (first + b) * g_stats_block);
+                std::size_t i_end = std::min(base + n, (first + b + 1) * g_stats_block);
+                for (std::size_t i = i_begin; i < i_end; ++i) {
+                    body(i - base, acc);
+                }
+            }
+        }
+    }, unsigned(t));
+    items += n;
+
+    // a partial last block stays open for the next batch
+    std::size_t closed = items % g_stats_block == 0 ? blocks : blocks - 1;
+    for (std::size_t b = 0; b < closed; ++b) {
+        for (std::size_t m = 0; m < metrics; ++m) {
+            merged[m].merge(block_moments[b * metrics + m]);
+        }
+    }
+    for (std::size_t m = 0; m < metrics; ++m) {
+        open[m] = closed < blocks ? block_moments[closed * metrics + m] : Moments();
+    }
+}
+
+// statistics over n items in one batch
+template<typename Body>
+std::vector<DistStats> accumulateStats(std::size_t n, std::size_t metrics, const Body& body, unsigned threads = 0) {
+    StatsStream stream(metrics, threads);
+    stream.add(n, body);
+    return stream.finish();
+}
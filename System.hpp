@@ -0,0 +1,38 @@
+/*
+ * File: System.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: one satellite system (operator) and the
+ *              inter-system interference matrix
+ * */
+
+#pragma once
+#include<vector>
+
+#include "Receiver.hpp"
+#include "SystemParams.hpp"
+
+struct System
+{
+    SystemParams params;
+    SatParamsPtr sat_class = ParamTable::defaultSat(); // record shared by every satellite
+    std::vector<Satellite> sats;
+    std::vector<Receiver> recs;
+};
+
+/*
+ * INR of every paired receiver (rows) against the active satellite of
+ * every paired receiver (columns), in dB
+ * entries where the row and column belong to the same system are -INF
+ * */
+struct InterferenceMatrix
+{
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::vector<int> row_sys;   // sys_id of the receiver in each row
+    std::vector<int> row_rec;   // rec_id of the receiver in each row
+    std::vector<int> col_sys;   // sys_id of the satellite in each column
+    std::vector<int> col_sat;   // sat_id of the satellite in each column
+    std::vector<double> inr_dB; // row major, rows x cols
+
+    double at(std::size_t r, std::size_t c) const { return inr_dB[r * cols + c]; }
+};
@@ -0,0 +1,28 @@
+/*
+ * File: SystemParams.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: per-system parameter record
+ *              values shared by every satellite of one operator
+ * */
+
+#pragma once
+#include<iostream>
+
+struct SystemParams
+{
+    int sys_id;
+    double Sp; // transmit power spectral density dBW/Hz
+};
+
+// built-in parameters for systems not listed in the input file
+inline SystemParams defaultSystemParams(int sys_id) {
+    switch (sys_id) {
+        case 1:
+            return {sys_id, -54.3};
+        case 2:
+            return {sys_id, -53.3};
+        default:
+            std::cerr << "Warning: no parameters for system " << sys_id << ", using system 1 values\n";
+            return {sys_id, -54.3};
+    }
+}
@@ -7,8 +7,13 @@
 #include<iostream>
 #include<filesystem>
 #include<fstream>
+#include<chrono>
+#include<stdexcept>
+#include<string>
 
 #include "SoS.hpp"
+#include "Server.hpp"
+#include "Globe.hpp"
 
 void generateInput(const std::string& filename) {
     std::ofstream out(filename);
@@ -43,7 +48,239 @@ void generateInput(const std::string& filename) {
     }
 }
 
-int main() {
+// two Walker-style shells and one receiver per system, as in generateInput
+ConstellationConfig scaleConfig(int planes, int sats_per_plane) {
+    ConstellationConfig config;
+    config.shells.push_back({1, planes, sats_per_plane, 550.0, 5.0, 1});
+    config.shells.push_back({2, planes, sats_per_plane, 610.0, 2.5, 1});
+    config.rec_grids.push_back({1, 1, 0.0, 8.0, 0.0});
+    config.rec_grids.push_back({2, 1, 0.0, 8.0, -1.0});
+    return config;
+}
+
+/*
+ * builds a two-system scenario in memory from Walker-style shells and
+ * times generation and protected selection, used for scaling studies
+ * */
+void runScaleStudy(int planes, int sats_per_plane) {
+    ConstellationConfig config = scaleConfig(planes, sats_per_plane);
+
+    auto t0 = std::chrono::steady_clock::now();
+    SoS sos;
+    sos.generateSystems(config);
+    auto t1 = std::chrono::steady_clock::now();
+    sos.aimSats();
+    sos.runSatelliteSelection(2);
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> gen = t1 - t0;
+    std::chrono::duration<double> sel = t2 - t1;
+    std::cout << "satellites per system: " << sos.constellationSys1().size() << "\n";
+    std::cout << "generation: " << gen.count() << " s\n";
+    std::cout << "protected selection: " << sel.count() << " s\n";
+}
+
+/*
+ * protected selection with the satellites streamed from an input file in
+ * blocks of block_size, for files larger than memory (see --write-input)
+ * */
+void runChunkedStudy(const std::string& filename, std::size_t block_size) {
+    ChunkConfig config;
+    config.block = block_size;
+    SoS sos;
+    auto t0 = std::chrono::steady_clock::now();
+    ChunkRunStats stats = sos.runChunked(filename, 2, config);
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    // the summary is only filled once both systems are paired
+    if (stats.summary.metrics.empty()) {
+        return;
+    }
+    std::ofstream out("chunk_selection.txt");
+    out << sos.analyze();
+    stats.summary.write("chunk_summary.txt");
+
+    std::cout << "satellites: " << stats.satellites << "\n";
+    std::cout << "passes: " << stats.passes << ", blocks: " << stats.blocks << "\n";
+    std::cout << "peak resident satellites: " << stats.peak_resident << "\n";
+    std::cout << "run time: " << dt.count() << " s\n";
+}
+
+/*
+ * protected selection on the globe: two Walker delta shells in ECEF and a
+ * terminal pair every 10 deg of latitude (+-60) and 30 deg of longitude
+ * */
+void runGlobeStudy(int planes, int sats_per_plane) {
+    int total = planes * sats_per_plane;
+    GlobeSystem sys1{1, {}, Satellite(1, 0, Vec2()).getEIRP_mW()};
+    GlobeSystem sys2{2, {}, Satellite(2, 0, Vec2()).getEIRP_mW()};
+
+    auto t0 = std::chrono::steady_clock::now();
+    walkerECEF({1, total, planes, 1, 550.0, 53.0}, 0.0, sys1.sats);
+    walkerECEF({2, total, planes, 1, 610.0, 42.0}, 0.0, sys2.sats);
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<GlobeSite> sites;
+    for (int lat = -60; lat <= 60; lat += 10) {
+        for (int lon = -180; lon < 180; lon += 30) {
+            sites.push_back({{lat * g_geo_pi / 180.0, lon * g_geo_pi / 180.0, 0.0}});
+        }
+    }
+    Receiver U(1, 1, Vec2(), 8.0);
+    Receiver V(2, 1, Vec2(), 8.0);
+    std::vector<GlobePairing> pairs = globeProtectedSelection(sys1, sys2, sites, U, V);
+    auto t2 = std::chrono::steady_clock::now();
+    globe_out("globe.txt", pairs);
+
+    int served = 0;
+    for (const GlobePairing& p : pairs) {
+        served += p.sat2 >= 0;
+    }
+    std::chrono::duration<double> gen = t1 - t0;
+    std::chrono::duration<double> sel = t2 - t1;
+    std::cout << "satellites per system: " << total << "\n";
+    std::cout << "terminal pairs served: " << served << " / " << pairs.size() << "\n";
+    std::cout << "generation: " << gen.count() << " s\n";
+    std::cout << "protected selection: " << sel.count() << " s\n";
+}
+
+/*
+ * N-system coexistence: every system picks its best SNR satellite, then
+ * the full inter-system interference matrix is written out
+ * */
+void runInterferenceStudy(const std::string& filename) {
+    SoS sos;
+    sos.buildSystems(filename);
+    sos.aimSats();
+    sos.runSatelliteSelection(1);
+    sos.interference_out("interference.txt");
+}
+
+/*
+ * protected selection scenario with the 400 MHz band split into channels,
+ * every channel is evaluated in the same pass over the constellation
+ * */
+void runChannelStudy(int count) {
+    generateInput("input.txt");
+    SoS sos;
+    sos.buildSystems("input.txt");
+    sos.setChannelPlan(ChannelPlan::uniform(20e9, 400e6, count));
+    sos.aimSats();
+    sos.runSatelliteSelection(2);
+    sos.channel_data_out("channel_data.txt");
+}
+
+/*
+ * agent-based run over the generated scenario, satellites drop out at
+ * random and receivers re-select as their events fire
+ * */
+void runAgentStudy(double t_end_s) {
+    generateInput("input.txt");
+    SoS sos;
+    sos.buildSystems("input.txt");
+    sos.aimSats();
+
+    AgentConfig config;
+    config.t_end_s = t_end_s;
+    auto t0 = std::chrono::steady_clock::now();
+    AgentStats stats = sos.runAgents(config);
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+
+    std::cout << "agent wake-ups: " << stats.resumes << "\n";
+    std::cout << "satellite outages: " << stats.outages << "\n";
+    std::cout << "receiver re-selections: " << stats.handovers << "\n";
+    std::cout << "full constellation scans: " << stats.full_scans << "\n";
+    std::cout << "interference events: " << stats.interference_events << "\n";
+    std::cout << "unserved receivers: " << stats.unserved << "\n";
+    std::cout << "run time: " << dt.count() << " s\n";
+    if (stats.unserved > 0) {
+        std::cerr << "Warning: receivers without a satellite, no analysis written\n";
+        return;
+    }
+    std::ofstream out("satSelection.txt");
+    out << sos.analyze();
+}
+
+/*
+ * primary system coverage after protected selection, nx by ny points
+ * spanning +-300 km along the surface and 0-10 km above it
+ * */
+void runCoverageStudy(int nx, int ny) {
+    generateInput("input.txt");
+    SoS sos;
+    sos.buildSystems("input.txt");
+    sos.aimSats();
+    sos.runSatelliteSelection(2);
+
+    CoverageGrid grid{-300.0, 300.0, nx, 0.0, 10.0, ny};
+    auto t0 = std::chrono::steady_clock::now();
+    CoverageMap map = sos.coverageMap(grid);
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    map.write("coverage.bin");
+    std::cout << "coverage points: " << map.snr_dB.size() << "\n";
+    std::cout << "coverage time: " << dt.count() << " s\n";
+}
+
+/*
+ * loads a scenario once (generated, or from an input file) and answers
+ * queries on a Unix-domain socket until a client sends SHUTDOWN
+ * */
+int runServer(const std::string& socket_path, const std::string& filename) {
+    if (filename.empty()) {
+        generateInput("input.txt");
+    }
+    SoS sos;
+    sos.buildSystems(filename.empty() ? "input.txt" : filename);
+    sos.aimSats();
+    sos.runSatelliteSelection(2);
+
+    try {
+        QueryServer server(sos, socket_path);
+        std::cout << "serving on " << socket_path << std::endl;
+        server.run();
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--scale") {
+        runScaleStudy(std::stoi(argv[2]), std::stoi(argv[3]));
+        return 0;
+    }
+    if (argc == 5 && std::string(argv[1]) == "--write-input") {
+        return writeInputFile(scaleConfig(std::stoi(argv[2]), std::stoi(argv[3])), argv[4]) ? 0 : 1;
+    }
+    if ((argc == 3 || argc == 4) && std::string(argv[1]) == "--chunked") {
+        runChunkedStudy(argv[2], argc == 4 ? std::stoul(argv[3]) : ChunkConfig().block);
+        return 0;
+    }
+    if (argc == 3 && std::string(argv[1]) == "--interference") {
+        runInterferenceStudy(argv[2]);
+        return 0;
+    }
+
+    if (argc == 3 && std::string(argv[1]) == "--agents") {
+        runAgentStudy(std::stod(argv[2]));
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--coverage") {
+        runCoverageStudy(std::stoi(argv[2]), std::stoi(argv[3]));
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--globe") {
+        runGlobeStudy(std::stoi(argv[2]), std::stoi(argv[3]));
+        return 0;
+    }
+    if ((argc == 3 || argc == 4) && std::string(argv[1]) == "--serve") {
+        return runServer(argv[2], argc == 4 ? argv[3] : "");
+    }
+    if (argc == 3 && std::string(argv[1]) == "--channels") {
+        runChannelStudy(std::stoi(argv[2]));
+        return 0;
+    }
+
     generateInput("input.txt");
     // build system
     SoS sos1;
@@ -71,8 +308,11 @@ int main() {
     out << sos3.analyze();
     out.close();
     
-    sos2.calc_data_out("calc_data.txt");
+    // the summary comes out of the calc_data loop, no second pass over the satellites
+    StatsSummary summary;
+    sos2.calc_data_out("calc_data.txt", summary);
     sos2.feasibleCount_out("feasibleCount.txt");
+    summary.write("summary.txt");
     return 0;
 }
 
@@ -0,0 +1,47 @@
+/*
+ * File: Verify.hpp
+ * Author: Jonathan S. Dufresne
+ * Description: differential check of the fast link paths against the
+ *              reference formulas in Receiver, plus a throughput floor
+ * */
+
+#pragma once
+#include<iostream>
+
+/*
+ * reference: Receiver::calc_SNR / calc_INR / calc_SINR / calc_Gt_int / calc_Gr_int
+ * and the original selection loops built on them
+ * checked:   LinkKernel, per-channel budget, ExclusionZone, computeCoverage,
+ *            LinkKernel3D and the geodetic transforms, all three
+ *            runSatelliteSelection modes, and agent runs on 1 and 4 threads
+ * on random geometry and on the edge cases of the reference (boresight,
+ * den < 1e-8, pattern nulls, 90 degrees off axis, unaimed satellites,
+ * satellites on the elevation mask, on the horizon and overhead)
+ * */
+struct VerifyConfig
+{
+    int cases = 20000;         // random geometries per check
+    int scenarios = 100;       // random two-system scenarios per selection mode
+    unsigned seed = 1;
+    double tol_dB = 1e-6;      // double precision paths
+    double tol_float_dB = 1e-3; // float32 coverage layers
+    // linear differences below this fraction of the boresight value are
+    // accepted, dB error is meaningless inside pattern nulls
+    double null_floor = 1e-9;
+    double min_links_per_s = 1e6; // LinkKernel::inr_lin throughput floor, 0 -> not enforced
+};
+
+struct VerifyReport
+{
+    long checks = 0;
+    long failures = 0;
+    double max_err_dB = 0;      // worst accepted dB difference above the null floor
+    double links_per_s = 0;     // LinkKernel::inr_lin
+    double ref_links_per_s = 0; // Receiver::calc_INR
+    bool throughput_ok = true;
+
+    bool passed() const { return failures == 0 && throughput_ok; }
+};
+
+// failures are described on log as they are found, a summary is written at the end
+VerifyReport runVerify(const VerifyConfig&, std::ostream& log = std::cout);
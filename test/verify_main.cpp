@@ -0,0 +1,29 @@
+/*
+ * File: verify_main.cpp
+ * Author: Jonathan S. Dufresne
+ * Description: entry point of the verify test, kept out of the sim binary
+ * */
+
+#include<string>
+
+#include "Verify.hpp"
+
+/*
+ * ./verify [cases] [min M links/s]
+ * fast paths against the reference formulas, nonzero exit on any mismatch
+ * or when inr_lin throughput drops below the floor (0 turns it off)
+ * */
+int main(int argc, char* argv[]) {
+    if (argc > 3) {
+        std::cerr << "usage: " << argv[0] << " [cases] [min M links/s]\n";
+        return 2;
+    }
+    VerifyConfig config;
+    if (argc > 1) {
+        config.cases = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        config.min_links_per_s = std::stod(argv[2]) * 1e6;
+    }
+    return runVerify(config).passed() ? 0 : 1;
+}